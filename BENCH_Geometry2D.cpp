@@ -0,0 +1,596 @@
+#include "olcUTIL_Geometry2D.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace olc::utils::geom2d;
+namespace geom2d = olc::utils::geom2d;
+
+// INSTRUCTIONS
+// ~~~~~~~~~~~~
+//
+// Console benchmark for the specialised rectangle routines. Each one is timed against
+// a reference that decomposes the rectangle into its four sides and uses the generic
+// line segment functions instead, which is how the library used to do it. Results are
+// compared as well, so a fast path that disagrees with the reference is reported.
+//
+// After the timings, the newer algorithms are cross-checked on random inputs against
+// simpler, slower ways of getting the same answer, reporting how many disagree.
+//
+// Build optimised for meaningful numbers.
+
+namespace reference
+{
+	// closest(r,p) via the closest point on each side
+	template<typename T1, typename T2>
+	olc::v_2d<T1> closest(const rect<T1>& r, const olc::v_2d<T2>& p)
+	{
+		olc::v_2d<T1> vClosest;
+		double dClosest = std::numeric_limits<double>::max();
+		for (size_t i = 0; i < r.side_count(); i++)
+		{
+			const auto c = geom2d::closest(r.side(i), p);
+			const double d = (c - p).mag2();
+			if (d < dClosest) { dClosest = d; vClosest = c; }
+		}
+		return vClosest;
+	}
+
+	// overlaps(r,l) via segment-segment tests on each side
+	template<typename T1, typename T2>
+	bool overlaps(const rect<T1>& r, const line<T2>& l)
+	{
+		return contains(r, l.start)
+			|| geom2d::overlaps(r.top(), l)
+			|| geom2d::overlaps(r.bottom(), l)
+			|| geom2d::overlaps(r.left(), l)
+			|| geom2d::overlaps(r.right(), l);
+	}
+
+	// intersects(r,l) via segment-segment intersection on each side
+	template<typename T1, typename T2>
+	std::vector<olc::v_2d<T2>> intersects(const rect<T1>& r, const line<T2>& l)
+	{
+		std::vector<olc::v_2d<T2>> intersections;
+		for (size_t i = 0; i < r.side_count(); i++)
+		{
+			auto v = geom2d::intersects(r.side(i), l);
+			intersections.insert(intersections.end(), v.begin(), v.end());
+		}
+		return internal::filter_duplicate_points(intersections);
+	}
+
+	// collision(q,r) via ray-segment intersection on each side
+	template<typename T1, typename T2>
+	std::optional<std::pair<olc::v_2d<T1>, olc::v_2d<T1>>> collision(const ray<T1>& q, const rect<T2>& r)
+	{
+		std::optional<std::pair<olc::v_2d<T1>, olc::v_2d<T1>>> vHit;
+		double dClosest = std::numeric_limits<double>::max();
+		for (size_t i = 0; i < r.side_count(); i++)
+		{
+			auto v = geom2d::intersects(q, r.side(i));
+			if (v.size() > 0 && (v[0] - q.origin).mag2() < dClosest)
+			{
+				dClosest = (v[0] - q.origin).mag2();
+				vHit = { v[0], r.side(i).vector().perp().norm() };
+			}
+		}
+		return vHit;
+	}
+
+	// project(c,r) via projecting onto the capsule around each side
+	template<typename T1, typename T2, typename T3>
+	std::optional<olc::v_2d<T2>> project(const circle<T1>& c, const rect<T2>& r, const ray<T3>& q)
+	{
+		std::optional<olc::v_2d<T2>> vClosest;
+		double dClosest = std::numeric_limits<double>::max();
+		for (size_t i = 0; i < r.side_count(); i++)
+		{
+			const auto s = geom2d::project(c, r.side(i), q);
+			if (s.has_value() && (s.value() - q.origin).mag2() < dClosest)
+			{
+				dClosest = (s.value() - q.origin).mag2();
+				vClosest = s;
+			}
+		}
+		return vClosest;
+	}
+
+	// Signed area of polygon by the shoelace formula, positive turning positively
+	template<typename T>
+	double area(const polygon<T>& p)
+	{
+		double dArea = 0.0;
+		for (size_t i = 0; i < p.pos.size(); i++)
+			dArea += olc::v_2d<double>(p.pos[i]).cross(olc::v_2d<double>(p.pos[(i + 1) % p.pos.size()]));
+		return dArea * 0.5;
+	}
+}
+
+struct Scenario
+{
+	std::vector<rect<float>> vRects;
+	std::vector<olc::vf2d> vPoints;
+	std::vector<line<float>> vLines;
+	std::vector<ray<float>> vRays;
+	std::vector<circle<float>> vCircles;
+};
+
+Scenario MakeScenario(const size_t nCount)
+{
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> dPos(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> dSize(1.0f, 60.0f);
+
+	Scenario s;
+	for (size_t i = 0; i < nCount; i++)
+	{
+		const olc::vf2d a = { dPos(rng), dPos(rng) };
+		const olc::vf2d b = { dPos(rng), dPos(rng) };
+		s.vRects.push_back({ { dPos(rng), dPos(rng) }, { dSize(rng), dSize(rng) } });
+		s.vPoints.push_back(a);
+		s.vLines.push_back({ a, b });
+		s.vRays.push_back({ a, (b - a).norm() });
+		s.vCircles.push_back({ {}, dSize(rng) * 0.2f });
+	}
+	return s;
+}
+
+// Times fBody over all scenario indices, repeated, returning nanoseconds per call
+template<typename F>
+double Time(const size_t nCount, const size_t nRepeats, F&& fBody)
+{
+	const auto tStart = std::chrono::high_resolution_clock::now();
+	for (size_t r = 0; r < nRepeats; r++)
+		for (size_t i = 0; i < nCount; i++)
+			fBody(i);
+	const auto tEnd = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::nano>(tEnd - tStart).count() / double(nCount * nRepeats);
+}
+
+void Report(const std::string& sName, const double dReference, const double dFast, const size_t nMismatches)
+{
+	std::cout << sName << ": reference " << dReference << " ns, specialised " << dFast << " ns, speedup x"
+		<< (dReference / dFast) << ", mismatches " << nMismatches << "\n";
+}
+
+void Check(const std::string& sName, const size_t nChecked, const size_t nMismatches)
+{
+	std::cout << sName << ": checked " << nChecked << ", mismatches " << nMismatches << "\n";
+}
+
+// Shapes moved by v, to step them through time
+rect<double> Moved(rect<double> r, const olc::vd2d& v) { r.pos += v; return r; }
+circle<double> Moved(circle<double> c, const olc::vd2d& v) { c.pos += v; return c; }
+triangle<double> Moved(triangle<double> t, const olc::vd2d& v) { for (auto& p : t.pos) p += v; return t; }
+polygon<double> Moved(polygon<double> g, const olc::vd2d& v) { for (auto& p : g.pos) p += v; return g; }
+
+// Star shaped polygon of n points around c, simple but usually concave
+polygon<double> MakeStar(std::mt19937& rng, const olc::vd2d& c, const double dRadius, const size_t n)
+{
+	std::uniform_real_distribution<double> dScale(0.3, 1.0);
+	polygon<double> p;
+	for (size_t i = 0; i < n; i++)
+	{
+		const double a = 2.0 * pi * double(i) / double(n);
+		p.pos.push_back(c + olc::vd2d(std::cos(a), std::sin(a)) * (dRadius * dScale(rng)));
+	}
+	return p;
+}
+
+int main()
+{
+	const size_t nCount = 100000;
+	const size_t nRepeats = 20;
+	const Scenario s = MakeScenario(nCount);
+
+	// Something for the optimiser to not throw away
+	volatile double dSink = 0.0;
+
+	{
+		// The reference accumulates float error walking along long sides, so is looser here
+		size_t nMismatches = 0;
+		for (size_t i = 0; i < nCount; i++)
+			if ((closest(s.vRects[i], s.vPoints[i]) - reference::closest(s.vRects[i], s.vPoints[i])).mag() > 0.05f)
+				nMismatches++;
+
+		const double dRef = Time(nCount, nRepeats, [&](size_t i) { dSink = dSink + reference::closest(s.vRects[i], s.vPoints[i]).x; });
+		const double dFast = Time(nCount, nRepeats, [&](size_t i) { dSink = dSink + closest(s.vRects[i], s.vPoints[i]).x; });
+		Report("closest(r,p)   ", dRef, dFast, nMismatches);
+	}
+
+	{
+		size_t nMismatches = 0;
+		for (size_t i = 0; i < nCount; i++)
+			if (overlaps(s.vRects[i], s.vLines[i]) != reference::overlaps(s.vRects[i], s.vLines[i]))
+				nMismatches++;
+
+		const double dRef = Time(nCount, nRepeats, [&](size_t i) { dSink = dSink + reference::overlaps(s.vRects[i], s.vLines[i]); });
+		const double dFast = Time(nCount, nRepeats, [&](size_t i) { dSink = dSink + overlaps(s.vRects[i], s.vLines[i]); });
+		Report("overlaps(r,l)  ", dRef, dFast, nMismatches);
+	}
+
+	{
+		size_t nMismatches = 0;
+		for (size_t i = 0; i < nCount; i++)
+		{
+			const auto a = intersects(s.vRects[i], s.vLines[i]);
+			const auto b = reference::intersects(s.vRects[i], s.vLines[i]);
+			if (a.size() != b.size())
+				nMismatches++;
+			else
+				for (size_t j = 0; j < a.size(); j++)
+					if ((a[j] - b[j]).mag() > 0.01f) { nMismatches++; break; }
+		}
+
+		const double dRef = Time(nCount, nRepeats, [&](size_t i) { dSink = dSink + reference::intersects(s.vRects[i], s.vLines[i]).size(); });
+		const double dFast = Time(nCount, nRepeats, [&](size_t i) { dSink = dSink + intersects(s.vRects[i], s.vLines[i]).size(); });
+		Report("intersects(r,l)", dRef, dFast, nMismatches);
+	}
+
+	{
+		size_t nMismatches = 0;
+		for (size_t i = 0; i < nCount; i++)
+		{
+			const auto a = collision(s.vRays[i], s.vRects[i]);
+			const auto b = reference::collision(s.vRays[i], s.vRects[i]);
+			if (a.has_value() != b.has_value() || (a.has_value() &&
+				((a->first - b->first).mag() > 0.01f || (a->second - b->second).mag() > 0.01f)))
+				nMismatches++;
+		}
+
+		const double dRef = Time(nCount, nRepeats, [&](size_t i) { dSink = dSink + reference::collision(s.vRays[i], s.vRects[i]).has_value(); });
+		const double dFast = Time(nCount, nRepeats, [&](size_t i) { dSink = dSink + collision(s.vRays[i], s.vRects[i]).has_value(); });
+		Report("collision(q,r) ", dRef, dFast, nMismatches);
+	}
+
+	{
+		// Circles are centred on the origin, and swept along a ray from elsewhere
+		size_t nMismatches = 0;
+		for (size_t i = 0; i < nCount; i++)
+		{
+			const auto a = project(s.vCircles[i], s.vRects[i], s.vRays[i]);
+			const auto b = reference::project(s.vCircles[i], s.vRects[i], s.vRays[i]);
+			if (a.has_value() != b.has_value() || (a.has_value() && (a.value() - b.value()).mag() > 0.01f))
+				nMismatches++;
+		}
+
+		const double dRef = Time(nCount, nRepeats / 4, [&](size_t i) { dSink = dSink + reference::project(s.vCircles[i], s.vRects[i], s.vRays[i]).has_value(); });
+		const double dFast = Time(nCount, nRepeats / 4, [&](size_t i) { dSink = dSink + project(s.vCircles[i], s.vRects[i], s.vRays[i]).has_value(); });
+		Report("project(c,r)   ", dRef, dFast, nMismatches);
+	}
+
+	{
+		// Triangles must cover the polygon exactly, so their areas add up to its own
+		std::mt19937 rng(34);
+		std::uniform_int_distribution<size_t> dPoints(3, 40);
+		const size_t nChecks = 2000;
+		size_t nMismatches = 0;
+		std::vector<triangle<double>> vTriangles;
+		for (size_t i = 0; i < nChecks; i++)
+		{
+			const auto p = MakeStar(rng, { 0.0, 0.0 }, 50.0, dPoints(rng));
+			vTriangles.clear();
+			const size_t nTriangles = triangulate(p, vTriangles);
+			double dArea = 0.0;
+			for (const auto& t : vTriangles) dArea += t.area();
+			const double dExpected = std::abs(reference::area(p));
+			if (nTriangles != p.pos.size() - 2 || std::abs(dArea - dExpected) > 1e-9 * dExpected)
+				nMismatches++;
+		}
+		Check("triangulate    ", nChecks, nMismatches);
+	}
+
+	{
+		// Union and intersection between them cover each polygon once, so their areas add
+		// up to both polygons' together, and the difference is what the intersection leaves.
+		// Against a convex polygon, clip() gives the intersection's area independently.
+		std::mt19937 rng(35);
+		std::uniform_int_distribution<size_t> dPoints(3, 24);
+		std::uniform_real_distribution<double> dOffset(-60.0, 60.0);
+		const size_t nChecks = 2000;
+		size_t nMismatches = 0;
+		clip_scratch scratch;
+		std::vector<polygon<double>> vResult;
+		auto rings_area = [&](const polygon<double>& a, const polygon<double>& b, const boolean_op op)
+		{
+			combine(a, b, op, vResult, scratch);
+			double dArea = 0.0;
+			for (const auto& r : vResult) dArea += reference::area(r);
+			return dArea;
+		};
+		for (size_t i = 0; i < nChecks; i++)
+		{
+			const auto a = MakeStar(rng, { 0.0, 0.0 }, 50.0, dPoints(rng));
+			auto b = MakeStar(rng, { dOffset(rng), dOffset(rng) }, 50.0, dPoints(rng));
+			const bool bConvex = i % 2 == 0;
+			if (bConvex) b = convex_hull(b.pos);
+			const double dA = reference::area(a), dB = reference::area(b);
+			const double dU = rings_area(a, b, boolean_op::unite);
+			const double dI = rings_area(a, b, boolean_op::intersect);
+			const double dD = rings_area(a, b, boolean_op::subtract);
+			const double dTolerance = 1e-6 * (dA + dB);
+			if (std::abs(dU + dI - dA - dB) > dTolerance || std::abs(dD + dI - dA) > dTolerance
+				|| (bConvex && std::abs(dI - std::abs(reference::area(clip(a, b)))) > dTolerance))
+				nMismatches++;
+		}
+		Check("combine        ", nChecks, nMismatches);
+	}
+
+	{
+		// distance() tries every pair of edges, GJK homes in on the closest features
+		std::mt19937 rng(37);
+		std::uniform_real_distribution<double> dPos(-40.0, 40.0);
+		std::uniform_real_distribution<double> dSize(1.0, 25.0);
+		size_t nChecks = 0, nMismatches = 0;
+		auto check = [&](const auto& a, const auto& b)
+		{
+			const auto g = gjk(a, b);
+			const double d = distance(a, b);
+			if (g.overlap != (d == 0.0) || std::abs(g.distance - d) > 1e-6 * std::max(1.0, d)) nMismatches++;
+			nChecks++;
+		};
+		for (size_t i = 0; i < 5000; i++)
+		{
+			const olc::vd2d p = { dPos(rng), dPos(rng) };
+			const line<double> l = { { dPos(rng), dPos(rng) }, { dPos(rng), dPos(rng) } };
+			const rect<double> r = { { dPos(rng), dPos(rng) }, { dSize(rng), dSize(rng) } };
+			const circle<double> c = { { dPos(rng), dPos(rng) }, dSize(rng) * 0.5 };
+			const triangle<double> t = { { dPos(rng), dPos(rng) }, { dPos(rng), dPos(rng) }, { dPos(rng), dPos(rng) } };
+			const triangle<double> t2 = { { dPos(rng), dPos(rng) }, { dPos(rng), dPos(rng) }, { dPos(rng), dPos(rng) } };
+			check(p, t); check(l, r); check(l, t); check(r, c); check(r, t);
+			check(c, t); check(c, l); check(t, t2);
+		}
+		Check("gjk            ", nChecks, nMismatches);
+	}
+
+	{
+		// contact() must find a manifold exactly when the shapes overlap, and pushing b out
+		// along the normal by the depth must leave them apart. Polygons sometimes repeat a
+		// vertex, as closed outlines often do.
+		std::mt19937 rng(38);
+		std::uniform_real_distribution<double> dPos(-20.0, 20.0);
+		std::uniform_real_distribution<double> dSize(1.0, 15.0);
+		size_t nChecks = 0, nMismatches = 0;
+		auto make_convex = [&](const olc::vd2d& c)
+		{
+			std::vector<olc::vd2d> vPoints;
+			for (size_t i = 0; i < 8; i++) vPoints.push_back(c + olc::vd2d(dPos(rng), dPos(rng)) * 0.5);
+			auto g = convex_hull(vPoints);
+			if (rng() % 3 == 0) g.pos.insert(g.pos.begin() + 1, g.pos[1]);
+			return g;
+		};
+		auto check = [&](const auto& a, const auto& b)
+		{
+			const auto m = contact(a, b);
+			nChecks++;
+			if (m.has_value() != overlaps(a, b)) { nMismatches++; return; }
+			if (m.has_value() && overlaps(a, Moved(b, m->normal * (m->penetration() + 1e-6))))
+				nMismatches++;
+		};
+		for (size_t i = 0; i < 5000; i++)
+		{
+			const auto a = make_convex({ 0.0, 0.0 });
+			const auto b = make_convex({ dPos(rng), dPos(rng) });
+			const circle<double> c = { { dPos(rng), dPos(rng) }, dSize(rng) * 0.5 };
+			check(a, b);
+			check(a, c);
+		}
+		Check("contact        ", nChecks, nMismatches);
+	}
+
+	{
+		// Stepping the shapes through the step finds roughly when they first overlap. toi()
+		// must not be later than that, and at the time it gives the shapes must touch.
+		std::mt19937 rng(47);
+		std::uniform_real_distribution<double> dPos(-20.0, 20.0);
+		std::uniform_real_distribution<double> dSize(1.0, 15.0);
+		std::uniform_real_distribution<double> dVelocity(-60.0, 60.0);
+		const size_t nSteps = 1000;
+		size_t nChecks = 0, nMismatches = 0;
+		auto check = [&](const auto& a, const auto& b)
+		{
+			const olc::vd2d va = { dVelocity(rng), dVelocity(rng) };
+			const olc::vd2d vb = { dVelocity(rng), dVelocity(rng) };
+			std::optional<double> tFirst;
+			for (size_t k = 0; k <= nSteps && !tFirst.has_value(); k++)
+			{
+				const double t = double(k) / double(nSteps);
+				if (overlaps(Moved(a, va * t), Moved(b, vb * t))) tFirst = t;
+			}
+
+			const auto hit = toi(a, va, b, vb);
+			nChecks++;
+			if (tFirst.has_value() && (!hit.has_value() || hit->t > *tFirst)) nMismatches++;
+			else if (hit.has_value() && gjk(Moved(a, va * hit->t), Moved(b, vb * hit->t)).distance > 1e-3) nMismatches++;
+		};
+		auto make_convex = [&](const olc::vd2d& c)
+		{
+			std::vector<olc::vd2d> vPoints;
+			for (size_t i = 0; i < 8; i++) vPoints.push_back(c + olc::vd2d(dPos(rng), dPos(rng)) * 0.5);
+			return convex_hull(vPoints);
+		};
+		for (size_t i = 0; i < 1000; i++)
+		{
+			const rect<double> r1 = { { dPos(rng), dPos(rng) }, { dSize(rng), dSize(rng) } };
+			const rect<double> r2 = { { dPos(rng), dPos(rng) }, { dSize(rng), dSize(rng) } };
+			const circle<double> c1 = { { dPos(rng), dPos(rng) }, dSize(rng) * 0.5 };
+			const circle<double> c2 = { { dPos(rng), dPos(rng) }, dSize(rng) * 0.5 };
+			const triangle<double> t = { { dPos(rng), dPos(rng) }, { dPos(rng), dPos(rng) }, { dPos(rng), dPos(rng) } };
+			check(r1, r2); check(r1, c1); check(c1, r2); check(c1, c2); check(t, c2);
+			check(make_convex({ dPos(rng), dPos(rng) }), make_convex({ dPos(rng), dPos(rng) }));
+		}
+		Check("toi            ", nChecks, nMismatches);
+	}
+
+	{
+		// Each circle is stepped along its path against every shape in the scene. sweep()
+		// must not report a hit later than the first overlap found, and must report one that
+		// the circle touches at that time. Circles starting overlapping are left out.
+		std::mt19937 rng(48);
+		std::uniform_real_distribution<double> dPos(-100.0, 100.0);
+		std::uniform_real_distribution<double> dSize(1.0, 10.0);
+		std::uniform_real_distribution<double> dVelocity(-40.0, 40.0);
+		scene<double> sc;
+		for (size_t i = 0; i < 40; i++)
+		{
+			const olc::vd2d p = { dPos(rng), dPos(rng) };
+			auto near = [&]() { return p + olc::vd2d(dSize(rng), dSize(rng)) * (rng() % 2 ? 1.0 : -1.0); };
+			sc.lines.push_back({ p, near() });
+			sc.rects.push_back({ { dPos(rng), dPos(rng) }, { dSize(rng), dSize(rng) } });
+			sc.circles.push_back({ { dPos(rng), dPos(rng) }, dSize(rng) * 0.5 });
+			sc.triangles.push_back({ p + olc::vd2d(20.0, 0.0), near() + olc::vd2d(20.0, 0.0), near() + olc::vd2d(20.0, 0.0) });
+			std::vector<olc::vd2d> vPoints;
+			for (size_t j = 0; j < 6; j++) vPoints.push_back(p + olc::vd2d(0.0, 20.0) + olc::vd2d(dSize(rng), dSize(rng)) - olc::vd2d(5.0, 5.0));
+			sc.polygons.push_back(convex_hull(vPoints));
+		}
+		sc.build();
+
+		auto shape_distance = [&](const scene_item& item, const circle<double>& c)
+		{
+			switch (item.kind)
+			{
+			case scene_kind::line: return gjk(sc.lines[item.index], c).distance;
+			case scene_kind::rect: return gjk(sc.rects[item.index], c).distance;
+			case scene_kind::circle: return gjk(sc.circles[item.index], c).distance;
+			case scene_kind::triangle: return gjk(sc.triangles[item.index], c).distance;
+			default: return gjk(sc.polygons[item.index], c).distance;
+			}
+		};
+		auto overlaps_scene = [&](const circle<double>& c)
+		{
+			for (const auto& l : sc.lines) if (overlaps(c, l)) return true;
+			for (const auto& r : sc.rects) if (overlaps(c, r)) return true;
+			for (const auto& q : sc.circles) if (overlaps(c, q)) return true;
+			for (const auto& t : sc.triangles) if (overlaps(c, t)) return true;
+			for (const auto& g : sc.polygons) if (overlaps(c, g)) return true;
+			return false;
+		};
+
+		std::vector<circle<double>> vCircles;
+		std::vector<olc::vd2d> vVelocities;
+		while (vCircles.size() < 2000)
+		{
+			const circle<double> c = { { dPos(rng), dPos(rng) }, dSize(rng) * 0.3 };
+			if (overlaps_scene(c)) continue;
+			vCircles.push_back(c);
+			vVelocities.push_back({ dVelocity(rng), dVelocity(rng) });
+		}
+		const auto vHits = sweep(sc, vCircles, vVelocities);
+
+		const size_t nSteps = 400;
+		size_t nMismatches = 0;
+		for (size_t i = 0; i < vCircles.size(); i++)
+		{
+			std::optional<double> tFirst;
+			for (size_t k = 1; k <= nSteps && !tFirst.has_value(); k++)
+			{
+				const double t = double(k) / double(nSteps);
+				if (overlaps_scene(Moved(vCircles[i], vVelocities[i] * t))) tFirst = t;
+			}
+
+			const auto& hit = vHits[i];
+			if (tFirst.has_value() && (!hit.has_value() || hit->t > *tFirst)) nMismatches++;
+			else if (hit.has_value() && shape_distance(hit->item, Moved(vCircles[i], vVelocities[i] * hit->t)) > 1e-3) nMismatches++;
+		}
+		Check("sweep          ", vCircles.size(), nMismatches);
+	}
+
+	{
+		// Shapes drift a little each frame, so most pairs are decided by the remembered
+		// axis, which must never disagree with testing the pair afresh
+		std::mt19937 rng(49);
+		std::uniform_real_distribution<double> dPos(-60.0, 60.0);
+		std::uniform_real_distribution<double> dDrift(-1.5, 1.5);
+		std::vector<polygon<double>> vPolygons;
+		std::vector<circle<double>> vCircles;
+		for (size_t i = 0; i < 40; i++)
+		{
+			const olc::vd2d c = { dPos(rng), dPos(rng) };
+			std::vector<olc::vd2d> vPoints;
+			for (size_t j = 0; j < 6; j++) vPoints.push_back(c + olc::vd2d(dPos(rng), dPos(rng)) * 0.15);
+			vPolygons.push_back(convex_hull(vPoints));
+			vCircles.push_back({ { dPos(rng), dPos(rng) }, 4.0 });
+		}
+
+		narrowphase np;
+		size_t nChecks = 0, nMismatches = 0;
+		const uint32_t nPolygons = uint32_t(vPolygons.size());
+		for (size_t nFrame = 0; nFrame < 50; nFrame++)
+		{
+			for (uint32_t i = 0; i < nPolygons; i++)
+			{
+				for (uint32_t j = i + 1; j < nPolygons; j++)
+				{
+					if (np.overlaps(narrowphase::pair_id(i, j), vPolygons[i], vPolygons[j]) != overlaps(vPolygons[i], vPolygons[j])) nMismatches++;
+					nChecks++;
+				}
+				for (uint32_t j = 0; j < nPolygons; j++)
+				{
+					if (np.overlaps(narrowphase::pair_id(i, nPolygons + j), vPolygons[i], vCircles[j]) != overlaps(vPolygons[i], vCircles[j])) nMismatches++;
+					nChecks++;
+				}
+			}
+			np.prune();
+
+			for (auto& g : vPolygons) g = Moved(g, { dDrift(rng), dDrift(rng) });
+			for (auto& c : vCircles) c = Moved(c, { dDrift(rng), dDrift(rng) });
+		}
+		Check("narrowphase    ", nChecks, nMismatches);
+	}
+
+	{
+		// Items share an island exactly when a breadth first search over the pairs reaches
+		// one from the other, and each island lists its items in ascending order
+		std::mt19937 rng(50);
+		size_t nChecks = 0, nMismatches = 0;
+		for (size_t nCase = 0; nCase < 201; nCase++)
+		{
+			const size_t n = nCase == 200 ? 200000 : 1 + rng() % 500;
+			const size_t nPairs = n * (rng() % 12) / 10;
+			std::vector<std::pair<uint32_t, uint32_t>> vPairs;
+			std::vector<std::vector<uint32_t>> vLinks(n);
+			for (size_t i = 0; i < nPairs; i++)
+			{
+				const uint32_t a = uint32_t(rng() % n), b = uint32_t(rng() % n);
+				vPairs.push_back({ a, b });
+				vLinks[a].push_back(b);
+				vLinks[b].push_back(a);
+			}
+
+			std::vector<uint32_t> vComponent(n, uint32_t(n));
+			uint32_t nComponents = 0;
+			std::vector<uint32_t> vQueue;
+			for (uint32_t i = 0; i < uint32_t(n); i++)
+			{
+				if (vComponent[i] != n) continue;
+				vQueue.assign(1, i);
+				vComponent[i] = nComponents;
+				for (size_t k = 0; k < vQueue.size(); k++)
+					for (const uint32_t j : vLinks[vQueue[k]])
+						if (vComponent[j] == n) { vComponent[j] = nComponents; vQueue.push_back(j); }
+				nComponents++;
+			}
+
+			const auto is = islands(n, vPairs);
+			bool bMatch = is.count() == nComponents && is.items.size() == n;
+			std::vector<uint32_t> vIslandOf(nComponents, uint32_t(n));
+			for (size_t i = 0; i < is.count() && bMatch; i++)
+			{
+				for (size_t k = 0; k < is.size(i) && bMatch; k++)
+				{
+					const uint32_t nItem = is.begin(i)[k];
+					auto& nIsland = vIslandOf[vComponent[nItem]];
+					if (nIsland == n) nIsland = uint32_t(i);
+					bMatch = nIsland == i && is.island[nItem] == i && (k == 0 || is.begin(i)[k - 1] < nItem);
+				}
+			}
+			if (!bMatch) nMismatches++;
+			nChecks++;
+		}
+		Check("islands        ", nChecks, nMismatches);
+	}
+
+	return 0;
+}
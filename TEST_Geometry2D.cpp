@@ -154,13 +154,17 @@ public:
 		return std::visit(dispatch, s1, s2);
 	}
 
-	std::optional<ray<float>> CheckReflect(const olc::utils::geom2d::ray<float>& s1, const ShapeWrap& s2)
+	std::optional<ray_hit<float>> CheckRaycast(const olc::utils::geom2d::ray<float>& s1, const ShapeWrap& s2, const float t_max)
 	{
 		const auto dispatch = overloads{
-			[&](const auto& a) -> std::optional<olc::utils::geom2d::ray<float>>
+			[&](const auto& a) -> std::optional<ray_hit<float>>
 			{
-				return reflect(s1, make_internal(a));
-			}
+				return raycast(s1, make_internal(a), t_max);
+			},
+
+			// Points and Rays have no surface to hit
+			[](const Point&) -> std::optional<ray_hit<float>> { return std::nullopt; },
+			[](const Ray&) -> std::optional<ray_hit<float>> { return std::nullopt; }
 		};
 
 		return std::visit(dispatch, s2);
@@ -394,17 +398,14 @@ public:
 				// Dont check against origin shape
 				if (i == last_hit_index) continue;
 
+				// Hits further than the closest so far are rejected early
 				const auto& vTargetShape = vecShapes[i];
-				auto hit = CheckReflect(ray_laser, vTargetShape);
+				auto hit = CheckRaycast(ray_laser, vTargetShape, fClosestDistance);
 				if (hit.has_value())
 				{
-					float d = (ray_laser.origin - hit.value().origin).mag();
-					if (d < fClosestDistance)
-					{
-						fClosestDistance = d;
-						closest_hit_index = i;
-						ray_reflected = hit.value();
-					}					
+					fClosestDistance = hit->t;
+					closest_hit_index = i;
+					ray_reflected = { ray_laser.origin + ray_laser.direction * hit->t, ray_laser.direction.reflect(hit->normal) };
 				}
 			}
 
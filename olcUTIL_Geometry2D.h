@@ -81,6 +81,21 @@
 		rectangle	- An axis aligned quad defined by a top left point, and a size
 		triangle	- A triangle defined by 3 points
 		ray			- A special case "line" with an origin and a direction
+		polygon		- A polygon defined by a list of points, convex unless a function says otherwise
+		sector		- A slice of a circle, either side of a direction from its middle, like a view cone
+
+	Prepared versions of line, rect, circle, triangle and polygon (prepared_line etc.) cache
+	values derived from the shape, making repeated queries against unchanging shapes cheaper.
+	A prepared_ray caches its inverse direction for raycast(). Wrapping shapes as guarded<>
+	caches their bounds, so queries between them can reject distant pairs cheaply.
+
+	Most functions taking a polygon - closest, overlaps, contains, intersects, project,
+	collision, raycast, distance, clip's clipping shape, gjk, contact, toi, minkowski_sum and the
+	bounding_rect functions - assume it is convex, and give wrong answers for a concave one
+	without complaint. Only triangulate, clip's clipped polygon, combine, simplify and
+	indexed_polygon accept concave polygons. The results of combine() and visibility() are often
+	concave, so do not pass them to the convex-only functions; wrap them in an indexed_polygon
+	or triangulate them first.
 
 	Functions have been provided that yield useful analyses for almost every combination
 	of shapes. The function groups all have the same names, and are differentiated via
@@ -114,6 +129,76 @@
 
 		optional<point, normal> collision(ray, a)
 			Returns the point and normal where a ray collides with Shape A
+
+		optional<t, normal, feature> raycast(ray, a, t_max)
+			Returns how far along a ray it collides with Shape A, if no further than t_max
+
+		double distance(a, b) / distance2(a, b)
+			Returns the (squared) distance between solid Shapes A and B, optionally with the
+			closest point on each
+
+		polygon convex_hull(points)
+			Returns the smallest convex polygon enclosing all of the points
+
+		size_t triangulate(polygon, triangles)
+			Splits a simple polygon, even concave, into triangles appended to a vector
+
+		polygon clip(polygon, a)
+			Returns the part of a polygon inside rectangle or convex polygon A
+
+		vector<polygon> combine(a, b, op)
+			Returns the union, intersection or difference of polygons A and B, even concave
+
+		polygon simplify_dp(a, epsilon) / simplify_vw(a, area)
+			Returns polyline or polygon A with fewer vertices, by Douglas-Peucker or
+			Visvalingam-Whyatt
+
+		gjk_result gjk(a, b)
+			Returns whether any two convex shapes overlap, and if not their distance and closest
+			points
+
+		optional<contact_manifold> contact(a, b)
+			Returns the normal, depth and points of contact between overlapping convex Shapes A
+			and B
+
+		polygon minkowski_sum(a, b) / offset(a, radius) / cspace_obstacle(a, b)
+			Returns convex polygon A grown by Shape B, for configuration space planning
+
+		polygon bounding_rect_area(a) / bounding_rect_perimeter(a)
+			Returns the oriented rectangle of least area or perimeter enclosing convex polygon A
+
+		line diameter(a) / double width(a)
+			Returns the furthest apart vertices, and the narrowest extent, of convex polygon A
+
+		vector<vector<point>> trace(scene, rays, bounces)
+			Returns the paths of rays reflecting around a scene of shapes
+
+		polygon visibility(point, segments, bounds)
+			Returns the region visible from a point among segments that block sight
+
+		bool traverse(ray, grid, visit)
+			Visits the cells of a tile grid a ray passes through, in order
+
+		bool occluded(ray, t_max, shapes) / occluded(line, shapes)
+			Returns true if anything blocks a ray before t_max, or a line between its ends
+
+		vector<index> overlaps(sector, shapes)
+			Returns the indices of the shapes that overlap a sector, rejecting cheaply first
+
+		size_t lighting::update()
+			Keeps the lit region of many lights among occluders, recomputing only what changed
+
+		optional<t, normal> toi(a, velocity_a, b, velocity_b)
+			Returns when during a step two moving convex shapes first touch, and the normal there
+
+		vector<optional<t, normal, item>> sweep(scene, circles, velocities)
+			Returns the first shape in a scene each of many moving circles touches
+
+		bool narrowphase::overlaps(pair, a, b)
+			Checks if two convex shapes overlap, trying the axis that last separated them first
+
+		island_set islands(n, pairs)
+			Groups items into islands connected by pairs, such as overlapping shapes
 	
 */
 
@@ -128,7 +213,7 @@
 	where:
 
 	f = overlaps, intersects, contains, closest, envelope_r, envelope_b, reflects, collision
-	a = p, l, r, c, t, q, pol (point, line, rect, circ, triangle, ray, polygon)
+	a = p, l, r, c, t, q, poly (point, line, rect, circ, triangle, ray, polygon)
 
 	example:
 
@@ -140,44 +225,50 @@
     Function Matrix - Function(A, B)
     ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-    A      B>|    POINT     |     LINE     |     RECT     |    CIRCLE    |   TRIANGLE   |      RAY     |
-    ---------+--------------+--------------+--------------+--------------+--------------+--------------+
-    POINT    | contains     | contains     | contains     | contains     | contains     |              |
-             | closest      | closest      | closest      | closest      | closest      | closest      |
-             | overlaps     | overlaps     | overlaps     | overlaps     | overlaps     |              |
-             | intersects   | intersects   | intersects   | intersects   | intersects   |              |
-             |              |              |              |              |              |              |
-    ---------+--------------+--------------+--------------+--------------+--------------+--------------+
-    LINE     | contains     | contains     | contains     | contains     | contains     |              |
-             | closest      |              |              | closest      |              |              |
-             | overlaps     | overlaps     | overlaps     | overlaps     | overlaps     |              |
-             | intersects   | intersects   | intersects   | intersects   | intersects   |              |
-             |              |              |              |              |              |              |
-    ---------+--------------+--------------+--------------+--------------+--------------+--------------+
-    RECT     | contains     | contains     | contains     | contains     | contains     |              |
-             | closest      |              |              |              |              |              |
-             | overlaps     | overlaps     | overlaps     | overlaps     | overlaps     |              |
-             | intersects   | intersects   | intersects   | intersects   | intersects   |              |
-             |              |              |              |              |              |              |
-    ---------+--------------+--------------+--------------+--------------+--------------+--------------+
-    CIRCLE   | contains     | contains     | contains     | contains     | contains     |              |
-             | closest      | closest      |              |              |              |              |
-             | overlaps     | overlaps     | overlaps     | overlaps     | overlaps     |              |
-             | intersects   | intersects   | intersects   | intersects   | intersects   |              |
-             | project      | project      |              | project      |              |              |
-    ---------+--------------+--------------+--------------+--------------+--------------+--------------+
-    TRIANGLE | contains     | contains     | contains     | contains     | contains     |              |
-             | closest      |              |              |              |              |              |
-             | overlaps     | overlaps     | overlaps     | overlaps     | overlaps     |              |
-             | intersects   | intersects   | intersects   | intersects   | intersects   |              |
-             |              |              |              |              |              |              |
-    ---------+--------------+--------------+--------------+--------------+--------------+--------------+
-    RAY      | contains     |              |              |              |              |              |
-             |              |              |              |              |              |              |
-             |              | collision    | collision    | collision    | collision    | collision*   |
-             |              | intersects   | intersects   | intersects   | intersects   | intersects   |
-             |              | reflect      | reflect      | reflect      | reflect      | reflect*     |
-    ---------+--------------+--------------+--------------+--------------+--------------+--------------+
+    A      B>|    POINT     |     LINE     |     RECT     |    CIRCLE    |   TRIANGLE   |      RAY     |   POLYGON    |
+    ---------+--------------+--------------+--------------+--------------+--------------+--------------+--------------+
+    POINT    | contains     | contains     | contains     | contains     | contains     |              |              |
+             | closest      | closest      | closest      | closest      | closest      | closest      |              |
+             | overlaps     | overlaps     | overlaps     | overlaps     | overlaps     |              | overlaps     |
+             | intersects   | intersects   | intersects   | intersects   | intersects   |              | intersects   |
+             |              |              |              |              |              |              |              |
+    ---------+--------------+--------------+--------------+--------------+--------------+--------------+--------------+
+    LINE     | contains     | contains     | contains     | contains     | contains     |              |              |
+             | closest      | closest      |              | closest      | closest      |              |              |
+             | overlaps     | overlaps     | overlaps     | overlaps     | overlaps     |              | overlaps     |
+             | intersects   | intersects   | intersects   | intersects   | intersects   |              | intersects   |
+             |              |              |              |              |              |              |              |
+    ---------+--------------+--------------+--------------+--------------+--------------+--------------+--------------+
+    RECT     | contains     | contains     | contains     | contains     | contains     |              | contains     |
+             | closest      | closest      |              | closest      | closest      |              |              |
+             | overlaps     | overlaps     | overlaps     | overlaps     | overlaps     |              | overlaps     |
+             | intersects   | intersects   | intersects   | intersects   | intersects   |              | intersects   |
+             |              |              |              |              |              |              |              |
+    ---------+--------------+--------------+--------------+--------------+--------------+--------------+--------------+
+    CIRCLE   | contains     | contains     | contains     | contains     | contains     |              | contains     |
+             | closest      | closest      |              | closest      | closest      |              |              |
+             | overlaps     | overlaps     | overlaps     | overlaps     | overlaps     |              | overlaps     |
+             | intersects   | intersects   | intersects   | intersects   | intersects   |              | intersects   |
+             | project      | project      | project      | project      | project      |              |              |
+    ---------+--------------+--------------+--------------+--------------+--------------+--------------+--------------+
+    TRIANGLE | contains     | contains     | contains     | contains     | contains     |              | contains     |
+             | closest      | closest      |              | closest      | closest      |              |              |
+             | overlaps     | overlaps     | overlaps     | overlaps     | overlaps     |              | overlaps     |
+             | intersects   | intersects   | intersects   | intersects   | intersects   |              | intersects   |
+             |              |              |              |              |              |              |              |
+    ---------+--------------+--------------+--------------+--------------+--------------+--------------+--------------+
+    RAY      | contains     |              |              |              |              |              |              |
+             | closest      |              |              |              |              |              |              |
+             |              | collision    | collision    | collision    | collision    | collision*   |              |
+             |              | intersects   | intersects   | intersects   | intersects   | intersects   |              |
+             |              | reflect      | reflect      | reflect      | reflect      | reflect*     |              |
+    ---------+--------------+--------------+--------------+--------------+--------------+--------------+--------------+
+    POLYGON  | contains     | contains     | contains     | contains     | contains     |              | contains     |
+             | closest      | closest      | closest      | closest      | closest      |              | closest      |
+             | overlaps     | overlaps     | overlaps     | overlaps     | overlaps     |              | overlaps     |
+             | intersects   | intersects   | intersects   | intersects   | intersects   |              | intersects   |
+             |              |              |              |              |              |              |              |
+    ---------+--------------+--------------+--------------+--------------+--------------+--------------+--------------+
 
 	* Exists but always fails
 */
@@ -191,6 +282,11 @@
 #include <optional>
 #include <cassert>
 #include <array>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <limits>
+#include <type_traits>
 
 
 #ifdef PGE_VER
@@ -544,6 +640,165 @@ namespace olc::utils::geom2d
 
 			return filtered_points;
 		}
+
+		// Clips the parametric range [t0, t1] of "s + t * v" to the slab lo <= x <= hi
+		inline constexpr bool clip_to_slab(const double s, const double v, const double lo, const double hi, double& t0, double& t1)
+		{
+			// Parallel to the slab, so either always inside it, or never
+			if (v == 0.0) return s >= lo && s <= hi;
+
+			const double r = 1.0 / v;
+			const double ta = (lo - s) * r;
+			const double tb = (hi - s) * r;
+			t0 = std::max(t0, std::min(ta, tb));
+			t1 = std::min(t1, std::max(ta, tb));
+			return true;
+		}
+
+		// Liang-Barsky: clips the parametric range [t0, t1] of "start + t * d" to the axis
+		// aligned box [vMin, vMax]. Returns false if nothing of the range remains
+		template<typename T1, typename T2>
+		inline constexpr bool clip_to_box(const olc::v_2d<T1>& start, const olc::v_2d<T1>& d,
+			const olc::v_2d<T2>& vMin, const olc::v_2d<T2>& vMax, double& t0, double& t1)
+		{
+			return clip_to_slab(start.x, d.x, vMin.x, vMax.x, t0, t1)
+				&& clip_to_slab(start.y, d.y, vMin.y, vMax.y, t0, t1)
+				&& t0 <= t1;
+		}
+
+		// Closest point on the boundary of the axis aligned box [vMin, vMax] to a point
+		template<typename T1, typename T2>
+		inline olc::v_2d<T1> closest_on_box(const olc::v_2d<T1>& vMin, const olc::v_2d<T1>& vMax, const olc::v_2d<T2>& p)
+		{
+			// Outside the box, clamping the point lands directly on the boundary
+			if (p.x < vMin.x || p.y < vMin.y || p.x > vMax.x || p.y > vMax.y)
+				return { std::clamp(T1(p.x), vMin.x, vMax.x), std::clamp(T1(p.y), vMin.y, vMax.y) };
+
+			// Inside, snap to the nearest side. Ties resolve top, bottom, left, right
+			const double dTop = p.y - vMin.y;
+			const double dBottom = vMax.y - p.y;
+			const double dLeft = p.x - vMin.x;
+			const double dRight = vMax.x - p.x;
+
+			olc::v_2d<T1> vClosest = { T1(p.x), vMin.y };
+			double dMin = dTop;
+
+			if (dBottom < dMin) {
+				dMin = dBottom;
+				vClosest = { T1(p.x), vMax.y };
+			}
+			if (dLeft < dMin) {
+				dMin = dLeft;
+				vClosest = { vMin.x, T1(p.y) };
+			}
+			if (dRight < dMin) {
+				dMin = dRight;
+				vClosest = { vMax.x, T1(p.y) };
+			}
+
+			return vClosest;
+		}
+
+		// Points where the segment "start + u * d", 0 <= u <= 1, crosses the boundary of the
+		// axis aligned box [vMin, vMax], in side order top, right, bottom, left
+		template<typename T1, typename T2>
+		inline std::vector<olc::v_2d<T2>> intersects_box(const olc::v_2d<T1>& vMin, const olc::v_2d<T1>& vMax,
+			const olc::v_2d<T2>& start, const olc::v_2d<T2>& d)
+		{
+			// Clip the segment to the box first, nothing left means nothing to intersect
+			double t0 = 0.0, t1 = 1.0;
+			if (!clip_to_box(start, d, vMin, vMax, t0, t1))
+				return {};
+
+			// Each side is axis aligned, so solve the segment directly for the side's
+			// constant coordinate, then check the other coordinate lies within the side
+			std::vector<olc::v_2d<T2>> intersections;
+
+			const auto horizontal = [&](const double y)
+			{
+				if (d.y == 0) return; // Parallel
+				const double u = (y - start.y) / d.y;
+				const double x = start.x + u * d.x;
+				if (u >= 0.0 && u <= 1.0 && x >= vMin.x && x <= vMax.x)
+					intersections.push_back({ T2(x), T2(y) });
+			};
+
+			const auto vertical = [&](const double x)
+			{
+				if (d.x == 0) return; // Parallel
+				const double u = (x - start.x) / d.x;
+				const double y = start.y + u * d.y;
+				if (u >= 0.0 && u <= 1.0 && y >= vMin.y && y <= vMax.y)
+					intersections.push_back({ T2(x), T2(y) });
+			};
+
+			horizontal(vMin.y);
+			vertical(vMax.x);
+			horizontal(vMax.y);
+			vertical(vMin.x);
+
+			return filter_duplicate_points(intersections);
+		}
+
+		// Closest points between segments "p1 + s * d1" and "p2 + t * d2", 0 <= s, t <= 1,
+		// returns squared distance between them
+		inline double closest_segment_segment(const olc::v_2d<double>& p1, const olc::v_2d<double>& d1,
+			const olc::v_2d<double>& p2, const olc::v_2d<double>& d2, double& s, double& t)
+		{
+			// Crossing segments are exactly zero apart, at their intersection
+			const double o1 = d1.cross(p2 - p1), o2 = d1.cross(p2 + d2 - p1);
+			const double o3 = d2.cross(p1 - p2), o4 = d2.cross(p1 + d1 - p2);
+			if (o1 * o2 <= 0.0 && o3 * o4 <= 0.0 && o1 != o2 && o3 != o4)
+			{
+				s = o3 / (o3 - o4);
+				t = o1 / (o1 - o2);
+				return 0.0;
+			}
+
+			const olc::v_2d<double> r = p1 - p2;
+			const double a = d1.mag2(), e = d2.mag2(), f = d2.dot(r);
+
+			if (a == 0.0 && e == 0.0)
+			{
+				// Both are points
+				s = t = 0.0;
+			}
+			else if (a == 0.0)
+			{
+				s = 0.0;
+				t = std::clamp(f / e, 0.0, 1.0);
+			}
+			else
+			{
+				const double c = d1.dot(r);
+				if (e == 0.0)
+				{
+					t = 0.0;
+					s = std::clamp(-c / a, 0.0, 1.0);
+				}
+				else
+				{
+					// Closest points of the infinite lines, then clamped back onto the segments
+					const double b = d1.dot(d2);
+					const double denom = a * e - b * b;
+					s = denom != 0.0 ? std::clamp((b * f - c * e) / denom, 0.0, 1.0) : 0.0;
+					t = (b * s + f) / e;
+
+					if (t < 0.0)
+					{
+						t = 0.0;
+						s = std::clamp(-c / a, 0.0, 1.0);
+					}
+					else if (t > 1.0)
+					{
+						t = 1.0;
+						s = std::clamp((b - c) / a, 0.0, 1.0);
+					}
+				}
+			}
+
+			return ((p1 + d1 * s) - (p2 + d2 * t)).mag2();
+		}
 	};
 
 	//https://stackoverflow.com/questions/1903954/is-there-a-standard-sign-function-signum-sgn-in-c-c
@@ -785,6 +1040,215 @@ namespace olc::utils::geom2d
 	struct polygon
 	{
 		std::vector<olc::v_2d<T>> pos;
+
+		// Get a line from an indexed side, the last side joins the final and first points
+		inline line<T> side(const size_t i) const
+		{
+			return line<T>(pos[i % pos.size()], pos[(i + 1) % pos.size()]);
+		}
+
+		// Returns side count: number of points
+		inline constexpr size_t side_count() const {
+			return pos.size();
+		}
+	};
+
+
+	template<typename T>
+	struct sector
+	{
+		// Apex, and direction the sector faces along
+		olc::v_2d<T> pos;
+		olc::v_2d<T> direction = { T(1), T(0) };
+		// Range, and angle either side of direction (radians, up to pi)
+		T radius = T(0);
+		T angle = T(0);
+
+		inline sector(const olc::v_2d<T>& p = { T(0), T(0) }, const olc::v_2d<T>& d = { T(1), T(0) }, const T r = T(0), const T a = T(0))
+			: pos(p), direction(d), radius(r), angle(a)
+		{ }
+
+		// Get a straight side from apex outwards, 0 at -angle from direction and 1 at +angle
+		inline line<T> side(const size_t i) const
+		{
+			const double a = (i % 2 == 0) ? -double(angle) : double(angle);
+			const olc::v_2d<double> d = olc::v_2d<double>(direction).norm();
+			const olc::v_2d<double> e = { d.x * std::cos(a) - d.y * std::sin(a), d.x * std::sin(a) + d.y * std::cos(a) };
+			return line<T>(pos, pos + olc::v_2d<T>(e * double(radius)));
+		}
+
+		// Get area of sector
+		inline constexpr T area() const
+		{
+			return angle * radius * radius;
+		}
+	};
+
+
+	// Prepared Shapes - The same shapes, but with quantities derived from them computed once
+	// up front, for geometry that is queried far more often than it changes (e.g. static level
+	// geometry). Each derives from its plain shape so works with every function, and selected
+	// functions have overloads that make use of the cached data. The cache is only filled on
+	// construction, so don't modify a prepared shape, construct a new one instead.
+
+	template<typename T>
+	struct prepared_line : public line<T>
+	{
+		// end - start, aka vector()
+		olc::v_2d<T> vec;
+		// Direction of line, aka vector().norm(), in double as it isn't whole for integer T
+		olc::v_2d<double> unit;
+		// Unit normal, aka vector().perp().norm()
+		olc::v_2d<double> normal;
+		// Length of line, length^2, and 1/length^2
+		double len = 0.0;
+		T len2 = T(0);
+		double inv_len2 = 0.0;
+		// Corners of bounding box
+		olc::v_2d<T> box_min;
+		olc::v_2d<T> box_max;
+
+		inline prepared_line(const line<T>& l = {})
+			: line<T>(l)
+		{
+			vec = l.vector();
+			len2 = vec.mag2();
+			len = std::sqrt(double(len2));
+			inv_len2 = len2 != T(0) ? 1.0 / double(len2) : 0.0;
+			unit = len != 0.0 ? olc::v_2d<double>(vec) / len : olc::v_2d<double>{};
+			normal = unit.perp();
+			box_min = l.start.min(l.end);
+			box_max = l.start.max(l.end);
+		}
+	};
+
+	template<typename T>
+	struct prepared_ray : public ray<T>
+	{
+		// 1 / direction, component-wise, infinite where direction is zero
+		olc::v_2d<double> inv_direction;
+
+		inline prepared_ray(const ray<T>& q = {})
+			: ray<T>(q)
+		{
+			inv_direction = { 1.0 / double(q.direction.x), 1.0 / double(q.direction.y) };
+		}
+	};
+
+	template<typename T>
+	struct prepared_rect : public rect<T>
+	{
+		// Bottom right corner, aka pos + size
+		olc::v_2d<T> pos_max;
+		// Centre of rectangle, aka middle()
+		olc::v_2d<T> centre;
+
+		inline prepared_rect(const rect<T>& r = {})
+			: rect<T>(r)
+		{
+			pos_max = r.pos + r.size;
+			centre = r.middle();
+		}
+	};
+
+	template<typename T>
+	struct prepared_circle : public circle<T>
+	{
+		// radius^2
+		T radius2 = T(0);
+		// Corners of bounding box
+		olc::v_2d<T> box_min;
+		olc::v_2d<T> box_max;
+
+		inline prepared_circle(const circle<T>& c = {})
+			: circle<T>(c)
+		{
+			radius2 = c.radius * c.radius;
+			box_min = c.pos - c.radius;
+			box_max = c.pos + c.radius;
+		}
+	};
+
+	template<typename T>
+	struct prepared_triangle : public triangle<T>
+	{
+		// Edge vectors, edge[i] = pos[i+1] - pos[i], aka side(i).vector()
+		std::array<olc::v_2d<T>, 3> edge;
+		// 1/length^2 of each edge
+		std::array<double, 3> inv_len2;
+		// Outward facing unit normal of each edge
+		std::array<olc::v_2d<double>, 3> normal;
+		// Extent of triangle projected onto each normal
+		std::array<double, 3> proj_min;
+		std::array<double, 3> proj_max;
+		// Signed area, positive when pos[0], pos[1], pos[2] turn positively (cross product)
+		double signed_area = 0.0;
+		// +1 or -1 depending on winding order
+		double winding = 1.0;
+		// Corners of bounding box
+		olc::v_2d<T> box_min;
+		olc::v_2d<T> box_max;
+
+		inline prepared_triangle(const triangle<T>& t = {})
+			: triangle<T>(t)
+		{
+			for (size_t i = 0; i < 3; i++)
+				edge[i] = t.pos[(i + 1) % 3] - t.pos[i];
+
+			signed_area = 0.5 * double(edge[0].cross(t.pos[2] - t.pos[0]));
+			winding = signed_area < 0.0 ? -1.0 : 1.0;
+
+			for (size_t i = 0; i < 3; i++)
+			{
+				const double len2 = double(edge[i].mag2());
+				inv_len2[i] = len2 != 0.0 ? 1.0 / len2 : 0.0;
+				normal[i] = len2 != 0.0 ? -olc::v_2d<double>(edge[i].perp()) * (winding / std::sqrt(len2)) : olc::v_2d<double>{};
+
+				// Edge i lies furthest along its own normal, the opposite vertex nearest
+				proj_max[i] = normal[i].dot(olc::v_2d<double>(t.pos[i]));
+				proj_min[i] = normal[i].dot(olc::v_2d<double>(t.pos[(i + 2) % 3]));
+			}
+
+			box_min = t.pos[0].min(t.pos[1].min(t.pos[2]));
+			box_max = t.pos[0].max(t.pos[1].max(t.pos[2]));
+		}
+	};
+
+	template<typename T>
+	struct prepared_polygon : public polygon<T>
+	{
+		// Outward facing normals of each side, not normalised
+		std::vector<olc::v_2d<double>> normal;
+		// Extent of polygon projected onto each normal, which its own side is furthest along
+		std::vector<double> proj_max;
+		// +1 or -1 depending on winding order
+		double winding = 1.0;
+		// Corners of bounding box
+		olc::v_2d<T> box_min;
+		olc::v_2d<T> box_max;
+
+		inline prepared_polygon(const polygon<T>& p = {})
+			: polygon<T>(p)
+		{
+			const size_t n = p.pos.size();
+			if (n == 0) return;
+
+			double dArea = 0.0;
+			for (size_t i = 0; i < n; i++)
+				dArea += olc::v_2d<double>(p.pos[i]).cross(olc::v_2d<double>(p.pos[(i + 1) % n]));
+			winding = dArea < 0.0 ? -1.0 : 1.0;
+
+			normal.resize(n);
+			proj_max.resize(n);
+			box_min = box_max = p.pos[0];
+			for (size_t i = 0; i < n; i++)
+			{
+				normal[i] = -(olc::v_2d<double>(p.pos[(i + 1) % n]) - olc::v_2d<double>(p.pos[i])).perp() * winding;
+				proj_max[i] = normal[i].dot(olc::v_2d<double>(p.pos[i]));
+				box_min = box_min.min(p.pos[i]);
+				box_max = box_max.max(p.pos[i]);
+			}
+		}
 	};
 
 
@@ -824,34 +1288,7 @@ namespace olc::utils::geom2d
 	template<typename T1, typename T2>
 	inline olc::v_2d<T1> closest(const rect<T1>& r, const olc::v_2d<T2>& p)
 	{
-		// Note: this algorithm can be reused for polygon
-		auto c1 = closest(r.top(), p);
-		auto c2 = closest(r.bottom(), p);
-		auto c3 = closest(r.left(), p);
-		auto c4 = closest(r.right(), p);
-
-		auto d1 = (c1 - p).mag2();
-		auto d2 = (c2 - p).mag2();
-		auto d3 = (c3 - p).mag2();
-		auto d4 = (c4 - p).mag2();
-
-		auto dmin = d1;
-		auto cmin = c1;
-
-		if (d2 < dmin) {
-			dmin = d2;
-			cmin = c2;
-		}
-		if (d3 < dmin) {
-			dmin = d3;
-			cmin = c3;
-		}
-		if (d4 < dmin) {
-			dmin = d4;
-			cmin = c4;
-		}
-
-		return cmin;
+		return internal::closest_on_box(r.pos, r.pos + r.size, p);
 	}
 
 	// closest(t,p)
@@ -887,8 +1324,8 @@ namespace olc::utils::geom2d
 	template<typename T1, typename T2>
 	inline olc::v_2d<T1> closest(const ray<T1>& r, const olc::v_2d<T2>& p)
 	{
-		// TODO: implement
-		return p;
+		const double u = std::max(0.0, double(r.direction.dot(p - r.origin)) / r.direction.mag2());
+		return r.origin + u * r.direction;
 	}
 
 
@@ -899,8 +1336,10 @@ namespace olc::utils::geom2d
 	template<typename T1, typename T2>
 	inline olc::v_2d<T1> closest(const line<T1>& l1, const line<T2>& l2)
 	{
-		// TODO:
-		return {};
+		double s, t;
+		const olc::v_2d<double> d1 = l1.vector();
+		internal::closest_segment_segment(l1.start, d1, l2.start, l2.vector(), s, t);
+		return olc::v_2d<double>(l1.start) + d1 * s;
 	}
 
 	// closest(r,l)
@@ -908,8 +1347,16 @@ namespace olc::utils::geom2d
 	template<typename T1, typename T2>
 	inline olc::v_2d<T1> closest(const rect<T1>& r, const line<T2>& l)
 	{
-		// TODO:
-		return {};
+		// Closest point on a side to the line is also as far from the line as that side is
+		olc::v_2d<T1> vClosest;
+		double dClosest = std::numeric_limits<double>::max();
+		for (size_t i = 0; i < r.side_count(); i++)
+		{
+			const auto p = closest(r.side(i), l);
+			const double d = (closest(l, p) - p).mag2();
+			if (d < dClosest) { dClosest = d; vClosest = p; }
+		}
+		return vClosest;
 	}
 
 	// closest(c,l)
@@ -926,8 +1373,15 @@ namespace olc::utils::geom2d
 	template<typename T1, typename T2>
 	inline olc::v_2d<T1> closest(const triangle<T1>& t, const line<T2>& l)
 	{
-		// TODO:
-		return {};
+		olc::v_2d<T1> vClosest;
+		double dClosest = std::numeric_limits<double>::max();
+		for (size_t i = 0; i < t.side_count(); i++)
+		{
+			const auto p = closest(t.side(i), l);
+			const double d = (closest(l, p) - p).mag2();
+			if (d < dClosest) { dClosest = d; vClosest = p; }
+		}
+		return vClosest;
 	}
 
 
@@ -945,10 +1399,9 @@ namespace olc::utils::geom2d
 	// closest(r,c)
 	// Returns closest point on rectangle to circle
 	template<typename T1, typename T2>
-	inline olc::v_2d<T1> closest(const rect<T1>& r, const circle<T2>& l)
+	inline olc::v_2d<T1> closest(const rect<T1>& r, const circle<T2>& c)
 	{
-		// TODO:
-		return {};
+		return closest(r, c.pos);
 	}
 
 	// closest(c,c)
@@ -962,10 +1415,9 @@ namespace olc::utils::geom2d
 	// closest(t,c)
 	// Returns closest point on triangle to circle
 	template<typename T1, typename T2>
-	inline olc::v_2d<T1> closest(const triangle<T1>& r, const circle<T2>& l)
+	inline olc::v_2d<T1> closest(const triangle<T1>& t, const circle<T2>& c)
 	{
-		// TODO:
-		return {};
+		return closest(t, c.pos);
 	}
 
 
@@ -974,37 +1426,58 @@ namespace olc::utils::geom2d
 	// closest(l,t)
 	// Returns closest point on line to triangle
 	template<typename T1, typename T2>
-	inline olc::v_2d<T1> closest(const line<T1>& l, const triangle<T2>& c)
+	inline olc::v_2d<T1> closest(const line<T1>& l, const triangle<T2>& t)
 	{
-		// TODO:
-		return {};
+		olc::v_2d<T1> vClosest;
+		double dClosest = std::numeric_limits<double>::max();
+		for (size_t i = 0; i < t.side_count(); i++)
+		{
+			const auto p = closest(l, t.side(i));
+			const double d = (closest(t.side(i), p) - p).mag2();
+			if (d < dClosest) { dClosest = d; vClosest = p; }
+		}
+		return vClosest;
 	}
 
 	// closest(r,t)
 	// Returns closest point on rectangle to triangle
 	template<typename T1, typename T2>
-	inline olc::v_2d<T1> closest(const rect<T1>& r, const triangle<T2>& l)
+	inline olc::v_2d<T1> closest(const rect<T1>& r, const triangle<T2>& t)
 	{
-		// TODO:
-		return {};
+		olc::v_2d<T1> vClosest;
+		double dClosest = std::numeric_limits<double>::max();
+		for (size_t i = 0; i < r.side_count(); i++)
+		{
+			const auto p = closest(r.side(i), t);
+			const double d = (closest(t, p) - p).mag2();
+			if (d < dClosest) { dClosest = d; vClosest = p; }
+		}
+		return vClosest;
 	}
 
 	// closest(c,t)
 	// Returns closest point on circle to triangle
 	template<typename T1, typename T2>
-	inline olc::v_2d<T1> closest(const circle<T1>& c, const triangle<T2>& l)
+	inline olc::v_2d<T1> closest(const circle<T1>& c, const triangle<T2>& t)
 	{
-		// TODO:
-		return {};
+		const auto p1 = closest(t, c.pos);
+		return c.pos + olc::vd2d(p1 - c.pos).norm() * c.radius;
 	}
 
 	// closest(t,t)
 	// Returns closest point on triangle to triangle
 	template<typename T1, typename T2>
-	inline olc::v_2d<T1> closest(const triangle<T1>& r, const triangle<T2>& l)
+	inline olc::v_2d<T1> closest(const triangle<T1>& t1, const triangle<T2>& t2)
 	{
-		// TODO:
-		return {};
+		olc::v_2d<T1> vClosest;
+		double dClosest = std::numeric_limits<double>::max();
+		for (size_t i = 0; i < t1.side_count(); i++)
+		{
+			const auto p = closest(t1.side(i), t2);
+			const double d = (closest(t2, p) - p).mag2();
+			if (d < dClosest) { dClosest = d; vClosest = p; }
+		}
+		return vClosest;
 	}
 
 	
@@ -1276,11 +1749,10 @@ namespace olc::utils::geom2d
 	template<typename T1, typename T2>
 	inline constexpr bool overlaps(const rect<T1>& r, const line<T2>& l)
 	{
-		return contains(r, l.start)
-			|| overlaps(r.top(), l)
-			|| overlaps(r.bottom(), l)
-			|| overlaps(r.left(), l)
-			|| overlaps(r.right(), l);
+		// If any part of the segment survives clipping to the rectangle, they overlap. This
+		// covers a segment starting inside too - testing for that first only adds branches
+		double t0 = 0.0, t1 = 1.0;
+		return internal::clip_to_box(l.start, l.vector(), r.pos, r.pos + r.size, t0, t1);
 	}
 
 	// overlaps(c,l)
@@ -1363,15 +1835,7 @@ namespace olc::utils::geom2d
 	template<typename T1, typename T2>
 	inline std::vector<olc::v_2d<T2>> intersects(const rect<T1>& r, const line<T2>& l)
 	{
-		std::vector<olc::v_2d<T2>> intersections;
-
-		for (size_t i = 0; i < r.side_count(); i++)
-		{
-			auto v = intersects(r.side(i), l);
-			intersections.insert(intersections.end(), v.begin(), v.end());
-		}
-
-		return internal::filter_duplicate_points(intersections);
+		return internal::intersects_box(r.pos, r.pos + r.size, l.start, l.vector());
 	}
 
 	// intersects(c,l)
@@ -2171,6 +2635,34 @@ namespace olc::utils::geom2d
 	template<typename T1, typename T2, typename T3>
 	inline std::optional<olc::v_2d<T2>> project(const circle<T1>& c, const rect<T2>& r, const ray<T3>& q)
 	{
+		const olc::vd2d vMin = r.pos;
+		const olc::vd2d vMax = r.pos + r.size;
+		const olc::vd2d vOrigin = q.origin;
+		const olc::vd2d vDirection = q.direction;
+		const double dRadius = c.radius;
+
+		if ((vOrigin.clamp(vMin, vMax) - vOrigin).mag2() > dRadius * dRadius)
+		{
+			// Swept-AABB: The circle starts clear of the rectangle, so its centre will first
+			// touch the rectangle inflated by the radius, a box with rounded corners
+			double t0 = 0.0, t1 = std::numeric_limits<double>::infinity();
+			if (!internal::clip_to_box(vOrigin, vDirection, vMin - dRadius, vMax + dRadius, t0, t1))
+				return std::nullopt;
+
+			// Entered through one of the flat sides
+			const olc::vd2d vEntry = vOrigin + vDirection * t0;
+			if ((vEntry.x >= vMin.x && vEntry.x <= vMax.x) || (vEntry.y >= vMin.y && vEntry.y <= vMax.y))
+				return olc::v_2d<T2>(vEntry);
+
+			// Entered a corner region, so can only touch that corner
+			const auto vContact = project(c, olc::v_2d<T2>(vEntry.clamp(vMin, vMax)), q);
+			if (vContact.has_value())
+				return olc::v_2d<T2>(vContact.value());
+
+			return std::nullopt;
+		}
+
+		// Circle already touches the rectangle, so test against the capsule around each side
 		const auto s1 = project(c, r.top(), q);
 		const auto s2 = project(c, r.bottom(), q);
 		const auto s3 = project(c, r.left(), q);
@@ -2354,33 +2846,50 @@ namespace olc::utils::geom2d
 	template<typename T1, typename T2>
 	inline std::optional<std::pair<olc::v_2d<T1>, olc::v_2d<T1>>> collision(const ray<T1>& q, const rect<T2>& r)
 	{
-		olc::v_2d<T1> vClosestIntersection;
-		olc::v_2d<T1> vIntersectionNormal;
-		double dClosestDistance2 = std::numeric_limits<double>::max();
-		bool bCollide = false;
+		// Slab test - intersect the ray's parametric range with the y and x extents of the
+		// rectangle, remembering which side (indexed as r.side(i)) bounds each end of it
+		double tNear = -std::numeric_limits<double>::infinity();
+		double tFar = std::numeric_limits<double>::infinity();
+		size_t nNear = 0, nFar = 0;
 
-		for (size_t i = 0; i < r.side_count(); i++)
+		if (q.direction.y != 0)
 		{
-			auto v = intersects(q, r.side(i));
-			if (v.size() > 0)
-			{
-				bCollide = true;
-				double d = (v[0] - q.origin).mag2();
-				if (d < dClosestDistance2)
-				{
-					dClosestDistance2 = d;
-					vClosestIntersection = v[0];
-					vIntersectionNormal = r.side(i).vector().perp().norm();
-				}
-			}
+			double t1 = (double(r.pos.y) - q.origin.y) / q.direction.y;
+			double t2 = (double(r.pos.y + r.size.y) - q.origin.y) / q.direction.y;
+			size_t n1 = 0, n2 = 2;
+			if (t1 > t2) { std::swap(t1, t2); std::swap(n1, n2); }
+			tNear = t1; nNear = n1;
+			tFar = t2; nFar = n2;
 		}
+		else if (q.origin.y < r.pos.y || q.origin.y > r.pos.y + r.size.y)
+			return std::nullopt; // Parallel and outside
 
-		if (bCollide)
+		if (q.direction.x != 0)
 		{
-			return { {vClosestIntersection, vIntersectionNormal} };
+			double t1 = (double(r.pos.x) - q.origin.x) / q.direction.x;
+			double t2 = (double(r.pos.x + r.size.x) - q.origin.x) / q.direction.x;
+			size_t n1 = 3, n2 = 1;
+			if (t1 > t2) { std::swap(t1, t2); std::swap(n1, n2); }
+
+			// Corner ties go to the lowest side index
+			if (t1 > tNear || (t1 == tNear && n1 < nNear)) { tNear = t1; nNear = n1; }
+			if (t2 < tFar || (t2 == tFar && n2 < nFar)) { tFar = t2; nFar = n2; }
 		}
+		else if (q.origin.x < r.pos.x || q.origin.x > r.pos.x + r.size.x)
+			return std::nullopt; // Parallel and outside
 
-		return std::nullopt;
+		if (tNear > tFar || tFar < 0.0) return std::nullopt;
+
+		// Ray starting inside the rectangle collides on the way out
+		const double t = tNear >= 0.0 ? tNear : tFar;
+		const size_t n = tNear >= 0.0 ? nNear : nFar;
+
+		// Normal matches r.side(n).vector().perp().norm()
+		const olc::v_2d<T1> vNormal = (n & 1)
+			? olc::v_2d<T1>{ T1(-sgn(r.size.y)), T1(0) }
+			: olc::v_2d<T1>{ T1(0), T1(sgn(r.size.x)) };
+
+		return { { q.origin + q.direction * t, vNormal } };
 	}
 
 	// reflect(q,r)
@@ -2545,6 +3054,5774 @@ namespace olc::utils::geom2d
 
 		return internal::filter_duplicate_points(intersections);
 	}
+
+
+	// PREPARED SHAPES ======================================================================================================
+
+	// Overloads that take advantage of the data cached by the prepared shapes. Anything not
+	// listed here still works, as prepared shapes are also plain shapes
+
+	// closest(pl,p)
+	// Returns closest point on prepared line to point
+	template<typename T1, typename T2>
+	inline olc::v_2d<T1> closest(const prepared_line<T1>& l, const olc::v_2d<T2>& p)
+	{
+		const double u = std::clamp(double(l.vec.dot(p - l.start)) * l.inv_len2, 0.0, 1.0);
+		return l.start + u * l.vec;
+	}
+
+	// contains(pl,p)
+	// Checks if prepared line contains point
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_line<T1>& l, const olc::v_2d<T2>& p)
+	{
+		const auto d = p - l.start;
+		if (std::abs(double(l.vec.cross(d))) < epsilon)
+		{
+			// point is on line
+			const double u = double(l.vec.dot(d)) * l.inv_len2;
+			return (u >= 0.0 && u <= 1.0);
+		}
+
+		return false;
+	}
+
+	// overlaps(pl,p)
+	// Checks if prepared line overlaps with point
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_line<T1>& l, const olc::v_2d<T2>& p)
+	{
+		return contains(l, p);
+	}
+
+	// overlaps(pl,l)
+	// Check if prepared line overlaps line segment
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_line<T1>& l1, const line<T2>& l2)
+	{
+		const auto d2 = l2.vector();
+		const auto d12 = l1.start - l2.start;
+		double D = d2.y * l1.vec.x - d2.x * l1.vec.y;
+		double uA = (d2.x * d12.y - d2.y * d12.x) / D;
+		double uB = (l1.vec.x * d12.y - l1.vec.y * d12.x) / D;
+		return uA >= 0 && uA <= 1 && uB >= 0 && uB <= 1;
+	}
+
+	// overlaps(pl,r)
+	// Check if prepared line overlaps rectangle
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_line<T1>& l, const rect<T2>& r)
+	{
+		double t0 = 0.0, t1 = 1.0;
+		return internal::clip_to_box(l.start, l.vec, r.pos, r.pos + r.size, t0, t1);
+	}
+
+	// overlaps(pl,c)
+	// Check if prepared line overlaps circle
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_line<T1>& l, const circle<T2>& c)
+	{
+		return (c.pos - closest(l, c.pos)).mag2() <= (c.radius * c.radius);
+	}
+
+
+
+	// contains(pr,p)
+	// Checks if prepared rectangle contains point
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_rect<T1>& r, const olc::v_2d<T2>& p)
+	{
+		return !(p.x < r.pos.x || p.y < r.pos.y || p.x > r.pos_max.x || p.y > r.pos_max.y);
+	}
+
+	// overlaps(pr,p)
+	// Checks if prepared rectangle overlaps with point
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_rect<T1>& r, const olc::v_2d<T2>& p)
+	{
+		return contains(r, p);
+	}
+
+	// closest(pr,p)
+	// Returns closest point on prepared rectangle to point
+	template<typename T1, typename T2>
+	inline olc::v_2d<T1> closest(const prepared_rect<T1>& r, const olc::v_2d<T2>& p)
+	{
+		return internal::closest_on_box(r.pos, r.pos_max, p);
+	}
+
+	// contains(pr,l)
+	// Check if prepared rectangle contains line segment
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_rect<T1>& r, const line<T2>& l)
+	{
+		return contains(r, l.start) && contains(r, l.end);
+	}
+
+	// overlaps(pr,l)
+	// Check if prepared rectangle overlaps line segment
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_rect<T1>& r, const line<T2>& l)
+	{
+		double t0 = 0.0, t1 = 1.0;
+		return internal::clip_to_box(l.start, l.vector(), r.pos, r.pos_max, t0, t1);
+	}
+
+	// intersects(pr,l)
+	// Get intersection points where prepared rectangle intersects with line segment
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T2>> intersects(const prepared_rect<T1>& r, const line<T2>& l)
+	{
+		return internal::intersects_box(r.pos, r.pos_max, l.start, l.vector());
+	}
+
+	// contains(pr,r)
+	// Check if prepared rectangle contains rectangle
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_rect<T1>& r1, const rect<T2>& r2)
+	{
+		return (r2.pos.x >= r1.pos.x) && (r2.pos.x + r2.size.x <= r1.pos_max.x) &&
+			(r2.pos.y >= r1.pos.y) && (r2.pos.y + r2.size.y <= r1.pos_max.y);
+	}
+
+	// overlaps(pr,r)
+	// Check if prepared rectangle overlaps rectangle
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_rect<T1>& r1, const rect<T2>& r2)
+	{
+		return (r1.pos.x <= r2.pos.x + r2.size.x && r1.pos_max.x >= r2.pos.x &&
+			r1.pos.y <= r2.pos.y + r2.size.y && r1.pos_max.y >= r2.pos.y);
+	}
+
+	// contains(pr,c)
+	// Check if prepared rectangle contains circle
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_rect<T1>& r, const circle<T2>& c)
+	{
+		return r.pos.x + c.radius <= c.pos.x
+			&& c.pos.x <= r.pos_max.x - c.radius
+			&& r.pos.y + c.radius <= c.pos.y
+			&& c.pos.y <= r.pos_max.y - c.radius;
+	}
+
+	// overlaps(pr,c)
+	// Check if prepared rectangle overlaps circle
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_rect<T1>& r, const circle<T2>& c)
+	{
+		const double dx = c.pos.x - std::clamp(c.pos.x, T2(r.pos.x), T2(r.pos_max.x));
+		const double dy = c.pos.y - std::clamp(c.pos.y, T2(r.pos.y), T2(r.pos_max.y));
+		return (dx * dx + dy * dy) < double(c.radius) * c.radius;
+	}
+
+	// contains(pr,t)
+	// Check if prepared rectangle contains triangle
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_rect<T1>& r, const triangle<T2>& t)
+	{
+		return contains(r, t.pos[0]) && contains(r, t.pos[1]) && contains(r, t.pos[2]);
+	}
+
+	// overlaps(pr,t)
+	// Check if prepared rectangle overlaps triangle
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_rect<T1>& r, const triangle<T2>& t)
+	{
+		// Bounding boxes must overlap first
+		const auto vMin = t.pos[0].min(t.pos[1].min(t.pos[2]));
+		const auto vMax = t.pos[0].max(t.pos[1].max(t.pos[2]));
+		if (vMax.x < r.pos.x || vMin.x > r.pos_max.x || vMax.y < r.pos.y || vMin.y > r.pos_max.y)
+			return false;
+
+		return overlaps(t, rect<T1>(r));
+	}
+
+
+
+	// contains(pc,p)
+	// Checks if prepared circle contains a point
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_circle<T1>& c, const olc::v_2d<T2>& p)
+	{
+		return (c.pos - p).mag2() <= c.radius2;
+	}
+
+	// overlaps(pc,p)
+	// Checks if prepared circle overlaps with point
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_circle<T1>& c, const olc::v_2d<T2>& p)
+	{
+		return contains(c, p);
+	}
+
+	// contains(pc,l)
+	// Check if prepared circle contains line segment
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_circle<T1>& c, const line<T2>& l)
+	{
+		return contains(c, l.start) && contains(c, l.end);
+	}
+
+	// overlaps(pc,l)
+	// Check if prepared circle overlaps line segment
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_circle<T1>& c, const line<T2>& l)
+	{
+		return (c.pos - closest(l, c.pos)).mag2() <= c.radius2;
+	}
+
+	// contains(pc,r)
+	// Check if prepared circle contains rectangle
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_circle<T1>& c, const rect<T2>& r)
+	{
+		// The furthest corner is all that matters
+		const double dx = std::max(std::abs(c.pos.x - r.pos.x), std::abs(c.pos.x - (r.pos.x + r.size.x)));
+		const double dy = std::max(std::abs(c.pos.y - r.pos.y), std::abs(c.pos.y - (r.pos.y + r.size.y)));
+		return (dx * dx + dy * dy) <= c.radius2;
+	}
+
+	// overlaps(pc,r)
+	// Check if prepared circle overlaps rectangle
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_circle<T1>& c, const rect<T2>& r)
+	{
+		const double dx = c.pos.x - std::clamp(c.pos.x, T1(r.pos.x), T1(r.pos.x + r.size.x));
+		const double dy = c.pos.y - std::clamp(c.pos.y, T1(r.pos.y), T1(r.pos.y + r.size.y));
+		return (dx * dx + dy * dy) < c.radius2;
+	}
+
+	// overlaps(pc,c)
+	// Check if prepared circle overlaps circle
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_circle<T1>& c1, const circle<T2>& c2)
+	{
+		return (c1.pos - c2.pos).mag2() <= (c1.radius + c2.radius) * (c1.radius + c2.radius);
+	}
+
+	// contains(pc,t)
+	// Check if prepared circle contains triangle
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_circle<T1>& c, const triangle<T2>& t)
+	{
+		return contains(c, t.pos[0]) && contains(c, t.pos[1]) && contains(c, t.pos[2]);
+	}
+
+	// overlaps(pc,t)
+	// Check if prepared circle overlaps triangle
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_circle<T1>& c, const triangle<T2>& t)
+	{
+		// Bounding boxes must overlap first
+		const auto vMin = t.pos[0].min(t.pos[1].min(t.pos[2]));
+		const auto vMax = t.pos[0].max(t.pos[1].max(t.pos[2]));
+		if (vMax.x < c.box_min.x || vMin.x > c.box_max.x || vMax.y < c.box_min.y || vMin.y > c.box_max.y)
+			return false;
+
+		return contains(t, c.pos) || (c.pos - closest(t, c.pos)).mag2() <= c.radius2;
+	}
+
+
+
+	// contains(pt,p)
+	// Checks if prepared triangle contains a point
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_triangle<T1>& t, const olc::v_2d<T2>& p)
+	{
+		// Inside, or on, all three edges
+		return double(t.edge[0].cross(p - t.pos[0])) * t.winding >= 0.0
+			&& double(t.edge[1].cross(p - t.pos[1])) * t.winding >= 0.0
+			&& double(t.edge[2].cross(p - t.pos[2])) * t.winding >= 0.0;
+	}
+
+	// overlaps(pt,p)
+	// Checks if prepared triangle overlaps with point
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_triangle<T1>& t, const olc::v_2d<T2>& p)
+	{
+		return contains(t, p);
+	}
+
+	// closest(pt,p)
+	// Returns closest point on prepared triangle to point
+	template<typename T1, typename T2>
+	inline olc::v_2d<T1> closest(const prepared_triangle<T1>& t, const olc::v_2d<T2>& p)
+	{
+		olc::v_2d<double> vClosest;
+		double dClosest = std::numeric_limits<double>::max();
+
+		for (size_t i = 0; i < 3; i++)
+		{
+			const double u = std::clamp(double(t.edge[i].dot(p - t.pos[i])) * t.inv_len2[i], 0.0, 1.0);
+			const olc::v_2d<double> c = t.pos[i] + u * t.edge[i];
+			const double d = (c - p).mag2();
+			if (d < dClosest)
+			{
+				dClosest = d;
+				vClosest = c;
+			}
+		}
+
+		return vClosest;
+	}
+
+	// contains(pt,l)
+	// Check if prepared triangle contains line segment
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_triangle<T1>& t, const line<T2>& l)
+	{
+		return contains(t, l.start) && contains(t, l.end);
+	}
+
+	// overlaps(pt,l)
+	// Check if prepared triangle overlaps line segment
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_triangle<T1>& t, const line<T2>& l)
+	{
+		// Separating axis test, first the bounding boxes...
+		const auto vMin = l.start.min(l.end);
+		const auto vMax = l.start.max(l.end);
+		if (vMax.x < t.box_min.x || vMin.x > t.box_max.x || vMax.y < t.box_min.y || vMin.y > t.box_max.y)
+			return false;
+
+		// ...then the triangle's edge normals...
+		for (size_t i = 0; i < 3; i++)
+		{
+			const double a = t.normal[i].dot(olc::v_2d<double>(l.start));
+			const double b = t.normal[i].dot(olc::v_2d<double>(l.end));
+			if (std::max(a, b) < t.proj_min[i] || std::min(a, b) > t.proj_max[i])
+				return false;
+		}
+
+		// ...then the line's normal
+		const olc::v_2d<double> n = olc::v_2d<double>(l.vector()).perp();
+		const double d = n.dot(olc::v_2d<double>(l.start));
+		const double p0 = n.dot(olc::v_2d<double>(t.pos[0]));
+		const double p1 = n.dot(olc::v_2d<double>(t.pos[1]));
+		const double p2 = n.dot(olc::v_2d<double>(t.pos[2]));
+		return std::min({ p0, p1, p2 }) <= d && std::max({ p0, p1, p2 }) >= d;
+	}
+
+	// intersects(pt,l)
+	// Get intersection points where prepared triangle intersects with line segment
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T2>> intersects(const prepared_triangle<T1>& t, const line<T2>& l)
+	{
+		const auto vMin = l.start.min(l.end);
+		const auto vMax = l.start.max(l.end);
+		if (vMax.x < t.box_min.x || vMin.x > t.box_max.x || vMax.y < t.box_min.y || vMin.y > t.box_max.y)
+			return {};
+
+		return intersects(triangle<T1>(t), l);
+	}
+
+	// contains(pt,r)
+	// Check if prepared triangle contains rectangle
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_triangle<T1>& t, const rect<T2>& r)
+	{
+		return contains(t, r.pos)
+			&& contains(t, r.pos + r.size)
+			&& contains(t, olc::v_2d<T2>{ r.pos.x + r.size.x, r.pos.y })
+			&& contains(t, olc::v_2d<T2>{ r.pos.x, r.pos.y + r.size.y });
+	}
+
+	// overlaps(pt,r)
+	// Check if prepared triangle overlaps rectangle
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_triangle<T1>& t, const rect<T2>& r)
+	{
+		// Separating axis test, the rectangle's axes are the bounding box test...
+		if (r.pos.x + r.size.x < t.box_min.x || r.pos.x > t.box_max.x || r.pos.y + r.size.y < t.box_min.y || r.pos.y > t.box_max.y)
+			return false;
+
+		// ...leaving the triangle's edge normals
+		for (size_t i = 0; i < 3; i++)
+		{
+			// Rectangle's projection is its centre's, plus or minus its half extent
+			const double c = t.normal[i].dot(olc::v_2d<double>(r.pos) + olc::v_2d<double>(r.size) * 0.5);
+			const double e = 0.5 * (std::abs(t.normal[i].x * r.size.x) + std::abs(t.normal[i].y * r.size.y));
+			if (c + e < t.proj_min[i] || c - e > t.proj_max[i])
+				return false;
+		}
+
+		return true;
+	}
+
+	// contains(pt,c)
+	// Check if prepared triangle contains circle
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_triangle<T1>& t, const circle<T2>& c)
+	{
+		// Centre must be at least a radius inside every edge
+		for (size_t i = 0; i < 3; i++)
+			if (t.proj_max[i] - t.normal[i].dot(olc::v_2d<double>(c.pos)) < c.radius)
+				return false;
+
+		return true;
+	}
+
+	// overlaps(pt,c)
+	// Check if prepared triangle overlaps circle
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_triangle<T1>& t, const circle<T2>& c)
+	{
+		if (c.pos.x + c.radius < t.box_min.x || c.pos.x - c.radius > t.box_max.x || c.pos.y + c.radius < t.box_min.y || c.pos.y - c.radius > t.box_max.y)
+			return false;
+
+		return contains(t, c.pos) || (c.pos - closest(t, c.pos)).mag2() <= c.radius * c.radius;
+	}
+
+	// contains(pt,t)
+	// Check if prepared triangle contains triangle
+	template<typename T1, typename T2>
+	inline constexpr bool contains(const prepared_triangle<T1>& t1, const triangle<T2>& t2)
+	{
+		return contains(t1, t2.pos[0]) && contains(t1, t2.pos[1]) && contains(t1, t2.pos[2]);
+	}
+
+	// overlaps(pt,t)
+	// Check if prepared triangle overlaps triangle
+	template<typename T1, typename T2>
+	inline constexpr bool overlaps(const prepared_triangle<T1>& t1, const triangle<T2>& t2)
+	{
+		// Separating axis test, first the bounding boxes...
+		const auto vMin = t2.pos[0].min(t2.pos[1].min(t2.pos[2]));
+		const auto vMax = t2.pos[0].max(t2.pos[1].max(t2.pos[2]));
+		if (vMax.x < t1.box_min.x || vMin.x > t1.box_max.x || vMax.y < t1.box_min.y || vMin.y > t1.box_max.y)
+			return false;
+
+		// ...then the cached normals of the prepared triangle...
+		for (size_t i = 0; i < 3; i++)
+		{
+			const double p0 = t1.normal[i].dot(olc::v_2d<double>(t2.pos[0]));
+			const double p1 = t1.normal[i].dot(olc::v_2d<double>(t2.pos[1]));
+			const double p2 = t1.normal[i].dot(olc::v_2d<double>(t2.pos[2]));
+			if (std::max({ p0, p1, p2 }) < t1.proj_min[i] || std::min({ p0, p1, p2 }) > t1.proj_max[i])
+				return false;
+		}
+
+		// ...then the other triangle's edge normals
+		for (size_t i = 0; i < 3; i++)
+		{
+			const olc::v_2d<double> n = olc::v_2d<double>(t2.pos[(i + 1) % 3] - t2.pos[i]).perp();
+			const double a0 = n.dot(olc::v_2d<double>(t2.pos[i]));
+			const double a1 = n.dot(olc::v_2d<double>(t2.pos[(i + 2) % 3]));
+			const double p0 = n.dot(olc::v_2d<double>(t1.pos[0]));
+			const double p1 = n.dot(olc::v_2d<double>(t1.pos[1]));
+			const double p2 = n.dot(olc::v_2d<double>(t1.pos[2]));
+			if (std::max({ p0, p1, p2 }) < std::min(a0, a1) || std::min({ p0, p1, p2 }) > std::max(a0, a1))
+				return false;
+		}
+
+		return true;
+	}
+
+
+	// RAYCASTS =============================================================================================================
+
+	// Parametric alternative to collision(ray, shape), which is cheaper for finding the
+	// nearest of many hits - no points are constructed, and the distance along the ray
+	// is returned directly so can be compared without square roots. Shapes further than
+	// t_max along the ray are rejected as early as possible, so passing the closest t
+	// found so far prunes the remaining tests.
+
+	// Describes where a ray hit a shape
+	template<typename T>
+	struct ray_hit
+	{
+		// Distance along ray, in multiples of its direction: hit = origin + direction * t
+		T t = T(0);
+		// Unit normal of the surface at the hit, facing back towards the ray
+		olc::v_2d<T> normal;
+		// Which part of the shape was hit, e.g. the side index for rect and triangle
+		size_t feature = 0;
+	};
+
+	namespace internal
+	{
+		// Distance along ray to where it crosses the segment "start + u * d", 0 <= u <= 1
+		template<typename T1, typename T2>
+		inline std::optional<double> raycast_segment(const ray<T1>& q, const olc::v_2d<T2>& start, const olc::v_2d<T2>& d, const double t_max)
+		{
+			const double cp1 = double(q.direction.x) * d.y - double(q.direction.y) * d.x;
+			if (cp1 == 0.0) return std::nullopt; // Parallel
+
+			const double ox = double(start.x) - q.origin.x;
+			const double oy = double(start.y) - q.origin.y;
+			const double t = (ox * d.y - oy * d.x) / cp1;
+			if (t < 0.0 || t > t_max) return std::nullopt;
+
+			const double u = (ox * q.direction.y - oy * q.direction.x) / cp1;
+			if (u < 0.0 || u > 1.0) return std::nullopt;
+
+			return t;
+		}
+
+		// Unit normal of segment direction d, facing against the ray direction
+		template<typename T1, typename T2>
+		inline olc::v_2d<T1> facing_normal(const olc::v_2d<T1>& direction, const olc::v_2d<T2>& d)
+		{
+			olc::v_2d<double> n = olc::v_2d<double>(d).perp().norm();
+			if (n.dot(olc::v_2d<double>(direction)) > 0.0) n = -n;
+			return n;
+		}
+
+		// Slab test of ray against the axis aligned box [vMin, vMax], with precomputed 1/direction
+		template<typename T1, typename T2>
+		inline std::optional<ray_hit<T1>> raycast_box(const ray<T1>& q, const olc::v_2d<double>& inv_dir,
+			const olc::v_2d<T2>& vMin, const olc::v_2d<T2>& vMax, const double t_max)
+		{
+			double tNear = 0.0, tFar = std::numeric_limits<double>::infinity();
+			size_t nNear = 0, nFar = 0;
+			bool bInside = true;
+
+			// y slab bounds top (0) and bottom (2), x slab bounds left (3) and right (1)
+			if (q.direction.y != 0)
+			{
+				const double t1 = (vMin.y - double(q.origin.y)) * inv_dir.y;
+				const double t2 = (vMax.y - double(q.origin.y)) * inv_dir.y;
+				const bool bFlip = t1 > t2;
+				const double tEnter = bFlip ? t2 : t1, tExit = bFlip ? t1 : t2;
+				if (tEnter > tNear) { tNear = tEnter; nNear = bFlip ? 2 : 0; bInside = false; }
+				tFar = tExit; nFar = bFlip ? 0 : 2;
+			}
+			else if (q.origin.y < vMin.y || q.origin.y > vMax.y)
+				return std::nullopt;
+
+			if (q.direction.x != 0)
+			{
+				const double t1 = (vMin.x - double(q.origin.x)) * inv_dir.x;
+				const double t2 = (vMax.x - double(q.origin.x)) * inv_dir.x;
+				const bool bFlip = t1 > t2;
+				const double tEnter = bFlip ? t2 : t1, tExit = bFlip ? t1 : t2;
+				if (tEnter > tNear) { tNear = tEnter; nNear = bFlip ? 1 : 3; bInside = false; }
+				if (tExit < tFar) { tFar = tExit; nFar = bFlip ? 3 : 1; }
+			}
+			else if (q.origin.x < vMin.x || q.origin.x > vMax.x)
+				return std::nullopt;
+
+			// Starting inside the box, the ray hits the side it leaves through
+			const double t = bInside ? tFar : tNear;
+			if (tNear > tFar || t > t_max) return std::nullopt;
+			const size_t n = bInside ? nFar : nNear;
+
+			// Outward normals of top, right, bottom and left, flipped to face the ray
+			constexpr int nx[4] = { 0, 1, 0, -1 };
+			constexpr int ny[4] = { -1, 0, 1, 0 };
+			const T1 s = bInside ? T1(-1) : T1(1);
+			return ray_hit<T1>{ T1(t), { T1(nx[n]) * s, T1(ny[n]) * s }, n };
+		}
+	}
+
+	// raycast(q,l,t)
+	// Returns distance along ray to where it hits line segment, if within t_max
+	template<typename T1, typename T2>
+	inline std::optional<ray_hit<T1>> raycast(const ray<T1>& q, const line<T2>& l, const double t_max = std::numeric_limits<double>::infinity())
+	{
+		const auto d = l.vector();
+		const auto t = internal::raycast_segment(q, l.start, d, t_max);
+		if (!t.has_value()) return std::nullopt;
+		return ray_hit<T1>{ T1(t.value()), internal::facing_normal(q.direction, d), 0 };
+	}
+
+	// raycast(q,r,t)
+	// Returns distance along ray to where it hits rectangle, if within t_max. Feature is side index.
+	template<typename T1, typename T2>
+	inline std::optional<ray_hit<T1>> raycast(const ray<T1>& q, const rect<T2>& r, const double t_max = std::numeric_limits<double>::infinity())
+	{
+		const olc::v_2d<double> inv_dir = { 1.0 / double(q.direction.x), 1.0 / double(q.direction.y) };
+		return internal::raycast_box(q, inv_dir, r.pos, r.pos + r.size, t_max);
+	}
+
+	// raycast(q,r,t)
+	// Returns distance along prepared ray to where it hits rectangle, if within t_max. Feature is side index.
+	template<typename T1, typename T2>
+	inline std::optional<ray_hit<T1>> raycast(const prepared_ray<T1>& q, const rect<T2>& r, const double t_max = std::numeric_limits<double>::infinity())
+	{
+		return internal::raycast_box(q, q.inv_direction, r.pos, r.pos + r.size, t_max);
+	}
+
+	// raycast(q,r,t)
+	// Returns distance along prepared ray to where it hits prepared rectangle, if within t_max. Feature is side index.
+	template<typename T1, typename T2>
+	inline std::optional<ray_hit<T1>> raycast(const prepared_ray<T1>& q, const prepared_rect<T2>& r, const double t_max = std::numeric_limits<double>::infinity())
+	{
+		return internal::raycast_box(q, q.inv_direction, r.pos, r.pos_max, t_max);
+	}
+
+	// raycast(q,c,t)
+	// Returns distance along ray to where it hits circle, if within t_max
+	template<typename T1, typename T2>
+	inline std::optional<ray_hit<T1>> raycast(const ray<T1>& q, const circle<T2>& c, const double t_max = std::numeric_limits<double>::infinity())
+	{
+		const double dx = double(q.origin.x) - c.pos.x;
+		const double dy = double(q.origin.y) - c.pos.y;
+		const double A = double(q.direction.x) * q.direction.x + double(q.direction.y) * q.direction.y;
+		const double B = dx * q.direction.x + dy * q.direction.y;
+		const double C = dx * dx + dy * dy - double(c.radius) * c.radius;
+		const bool bInside = C <= 0.0;
+
+		// Outside and heading away, or missing entirely
+		if (A == 0.0 || (!bInside && B > 0.0)) return std::nullopt;
+		const double D = B * B - A * C;
+		if (D < 0.0) return std::nullopt;
+
+		// Entry beyond t_max, rejected without the square root
+		const double E = -B - A * t_max;
+		if (!bInside && E > 0.0 && E * E > D) return std::nullopt;
+
+		// From inside the circle the ray hits the far side
+		const double sqrtD = std::sqrt(D);
+		const double t = bInside ? (-B + sqrtD) / A : (-B - sqrtD) / A;
+		if (t > t_max) return std::nullopt;
+
+		olc::v_2d<double> n = { dx + t * q.direction.x, dy + t * q.direction.y };
+		n = bInside ? -n.norm() : n.norm();
+		return ray_hit<T1>{ T1(t), n, 0 };
+	}
+
+	// raycast(q,t,t)
+	// Returns distance along ray to where it first hits triangle, if within t_max. Feature is side index.
+	template<typename T1, typename T2>
+	inline std::optional<ray_hit<T1>> raycast(const ray<T1>& q, const triangle<T2>& tri, const double t_max = std::numeric_limits<double>::infinity())
+	{
+		double tClosest = t_max;
+		size_t nSide = tri.side_count();
+		for (size_t i = 0; i < tri.side_count(); i++)
+		{
+			// Each hit tightens the bound on the remaining sides
+			const auto t = internal::raycast_segment(q, tri.pos[i], tri.pos[(i + 1) % 3] - tri.pos[i], tClosest);
+			if (t.has_value()) { tClosest = t.value(); nSide = i; }
+		}
+
+		if (nSide == tri.side_count()) return std::nullopt;
+		return ray_hit<T1>{ T1(tClosest), internal::facing_normal(q.direction, tri.pos[(nSide + 1) % 3] - tri.pos[nSide]), nSide };
+	}
+
+	// raycast(q,poly,t)
+	// Returns distance along ray to where it first hits polygon, if within t_max. Feature is side index.
+	template<typename T1, typename T2>
+	inline std::optional<ray_hit<T1>> raycast(const ray<T1>& q, const polygon<T2>& poly, const double t_max = std::numeric_limits<double>::infinity())
+	{
+		double tClosest = t_max;
+		const size_t n = poly.pos.size();
+		size_t nSide = n;
+		for (size_t i = 0; i < n; i++)
+		{
+			const auto t = internal::raycast_segment(q, poly.pos[i], poly.pos[(i + 1) % n] - poly.pos[i], tClosest);
+			if (t.has_value()) { tClosest = t.value(); nSide = i; }
+		}
+
+		if (nSide == n) return std::nullopt;
+		return ray_hit<T1>{ T1(tClosest), internal::facing_normal(q.direction, poly.pos[(nSide + 1) % n] - poly.pos[nSide]), nSide };
+	}
+
+	// DISTANCE =============================================================================================================
+
+	// distance2(a,b) / distance(a,b)
+	// Returns how far apart two shapes are. Unlike closest(), rectangles, circles and triangles
+	// are treated as solid, so shapes that overlap are zero apart. Optionally also returns the
+	// witness points, one on each shape, that are that distance apart. distance2() only needs
+	// a square root when either shape is a circle.
+
+	namespace internal
+	{
+		// Any of point, line, rect, triangle and circle, as a convex outline of up to four
+		// vertices inflated by a radius
+		struct distance_shape
+		{
+			std::array<olc::v_2d<double>, 4> vertex;
+			size_t count = 0;
+			double radius = 0.0;
+		};
+
+		template<typename T>
+		inline distance_shape as_distance_shape(const olc::v_2d<T>& p)
+		{
+			return { { p }, 1, 0.0 };
+		}
+
+		template<typename T>
+		inline distance_shape as_distance_shape(const line<T>& l)
+		{
+			return { { l.start, l.end }, 2, 0.0 };
+		}
+
+		template<typename T>
+		inline distance_shape as_distance_shape(const rect<T>& r)
+		{
+			return { { r.pos, r.pos + olc::v_2d<T>(r.size.x, 0), r.pos + r.size, r.pos + olc::v_2d<T>(0, r.size.y) }, 4, 0.0 };
+		}
+
+		template<typename T>
+		inline distance_shape as_distance_shape(const circle<T>& c)
+		{
+			return { { c.pos }, 1, double(c.radius) };
+		}
+
+		template<typename T>
+		inline distance_shape as_distance_shape(const triangle<T>& t)
+		{
+			return { { t.pos[0], t.pos[1], t.pos[2] }, 3, 0.0 };
+		}
+
+		// True if p lies within or on the convex outline, of either winding
+		inline bool distance_shape_contains(const distance_shape& a, const olc::v_2d<double>& p)
+		{
+			if (a.count < 3) return false;
+			bool bPositive = false, bNegative = false;
+			for (size_t i = 0; i < a.count; i++)
+			{
+				const double c = (a.vertex[(i + 1) % a.count] - a.vertex[i]).cross(p - a.vertex[i]);
+				bPositive |= c > 0.0;
+				bNegative |= c < 0.0;
+			}
+			return !(bPositive && bNegative);
+		}
+
+		// Only shapes with an as_distance_shape() take part in distance(), keeping it clear of std::distance()
+		template<typename S1, typename S2>
+		using distance_shape_of = decltype(as_distance_shape(std::declval<S1>()), as_distance_shape(std::declval<S2>()));
+
+		// Squared distance between the outlines, ignoring radius, with witness points
+		inline double distance2_outline(const distance_shape& a, const distance_shape& b, olc::v_2d<double>& vOnA, olc::v_2d<double>& vOnB)
+		{
+			// One inside the other (vertex 0 suffices for convex shapes that don't cross)
+			if (distance_shape_contains(a, b.vertex[0])) { vOnA = vOnB = b.vertex[0]; return 0.0; }
+			if (distance_shape_contains(b, a.vertex[0])) { vOnA = vOnB = a.vertex[0]; return 0.0; }
+
+			// Otherwise closest pair of edges, a point being a single zero length edge
+			const size_t nEdgesA = a.count < 3 ? 1 : a.count;
+			const size_t nEdgesB = b.count < 3 ? 1 : b.count;
+			double dClosest = std::numeric_limits<double>::max();
+			for (size_t i = 0; i < nEdgesA; i++)
+			{
+				const auto& p1 = a.vertex[i];
+				const auto d1 = a.vertex[(i + 1) % a.count] - p1;
+				for (size_t j = 0; j < nEdgesB; j++)
+				{
+					const auto& p2 = b.vertex[j];
+					const auto d2 = b.vertex[(j + 1) % b.count] - p2;
+					double s, t;
+					const double d = closest_segment_segment(p1, d1, p2, d2, s, t);
+					if (d < dClosest)
+					{
+						dClosest = d;
+						vOnA = p1 + d1 * s;
+						vOnB = p2 + d2 * t;
+						if (d == 0.0) return 0.0;
+					}
+				}
+			}
+			return dClosest;
+		}
+
+		// Squared distance between the shapes, with witness points
+		inline double distance2(const distance_shape& a, const distance_shape& b, olc::v_2d<double>& vOnA, olc::v_2d<double>& vOnB)
+		{
+			const double d2 = distance2_outline(a, b, vOnA, vOnB);
+			if (a.radius == 0.0 && b.radius == 0.0) return d2;
+
+			// Circles pull the witness points towards each other by their radii
+			const double d = std::sqrt(d2);
+			const double r = a.radius + b.radius;
+			if (d > r)
+			{
+				const auto n = (vOnB - vOnA) / d;
+				vOnA += n * a.radius;
+				vOnB -= n * b.radius;
+				return (d - r) * (d - r);
+			}
+
+			// Overlapping, so find a point common to both
+			if (d > 0.0) vOnA += (vOnB - vOnA) * (std::min(a.radius, d) / d);
+			vOnB = vOnA;
+			return 0.0;
+		}
+	}
+
+	// distance2(a,b)
+	// Returns squared distance between shape a and shape b
+	template<typename S1, typename S2, typename = internal::distance_shape_of<S1, S2>>
+	inline double distance2(const S1& a, const S2& b)
+	{
+		olc::v_2d<double> vOnA, vOnB;
+		return internal::distance2(internal::as_distance_shape(a), internal::as_distance_shape(b), vOnA, vOnB);
+	}
+
+	// distance2(a,b,wa,wb)
+	// Returns squared distance between shape a and shape b, and the points on each that are closest
+	template<typename S1, typename S2, typename T, typename = internal::distance_shape_of<S1, S2>>
+	inline double distance2(const S1& a, const S2& b, olc::v_2d<T>& vOnA, olc::v_2d<T>& vOnB)
+	{
+		olc::v_2d<double> vA, vB;
+		const double d = internal::distance2(internal::as_distance_shape(a), internal::as_distance_shape(b), vA, vB);
+		vOnA = vA;
+		vOnB = vB;
+		return d;
+	}
+
+	// distance(a,b)
+	// Returns distance between shape a and shape b
+	template<typename S1, typename S2, typename = internal::distance_shape_of<S1, S2>>
+	inline double distance(const S1& a, const S2& b)
+	{
+		return std::sqrt(distance2(a, b));
+	}
+
+	// distance(a,b,wa,wb)
+	// Returns distance between shape a and shape b, and the points on each that are closest
+	template<typename S1, typename S2, typename T, typename = internal::distance_shape_of<S1, S2>>
+	inline double distance(const S1& a, const S2& b, olc::v_2d<T>& vOnA, olc::v_2d<T>& vOnB)
+	{
+		return std::sqrt(distance2(a, b, vOnA, vOnB));
+	}
+
+	// GUARDED QUERIES ======================================================================================================
+
+	// A guarded shape carries its envelope_r() and envelope_c() bounds, cached when it is
+	// constructed. Queries between guarded shapes compare those bounds first, and only
+	// run the exact test when they touch, which is a big saving for expensive pairs such
+	// as triangle vs triangle in sparse scenes. A guarded shape is still its shape, so it
+	// can be passed to anything else as normal. Reconstruct it if the shape changes.
+	//
+	// Bounds are kept in double, with slack for any rounding in the shape's own type, so
+	// they only ever reject pairs that really are apart. Integer shapes go without the
+	// bounding circle, as envelope_c() would round it.
+
+	template<typename S>
+	struct guarded : public S
+	{
+		rect<double> box;
+		circle<double> bound;
+		// Amount box may fall short of the shape by
+		double slack = 0.0;
+
+		inline guarded(const S& s = {})
+			: S(s)
+		{
+			const auto r = envelope_r(s);
+			using T = std::remove_cv_t<decltype(r.pos.x)>;
+			box = { r.pos, r.size };
+			if constexpr (std::is_floating_point_v<T>)
+			{
+				const double dEpsilon = 4.0 * double(std::numeric_limits<T>::epsilon());
+				slack = dEpsilon * (std::abs(box.pos.x) + std::abs(box.pos.y) + std::abs(box.size.x) + std::abs(box.size.y));
+				const auto c = envelope_c(s);
+				bound = { c.pos, double(c.radius) };
+				bound.radius += 2.0 * dEpsilon * (std::abs(bound.pos.x) + std::abs(bound.pos.y) + bound.radius);
+			}
+			else
+			{
+				bound = { box.pos + box.size * 0.5, std::numeric_limits<double>::infinity() };
+			}
+		}
+	};
+
+	// Tallies of guarded queries, and how many of them were decided by the bounds alone
+	struct guard_stats
+	{
+		size_t queries = 0;
+		size_t rejected = 0;
+
+		inline double rejection_rate() const
+		{
+			return queries > 0 ? double(rejected) / double(queries) : 0.0;
+		}
+
+		inline void reset()
+		{
+			queries = 0;
+			rejected = 0;
+		}
+	};
+
+	// Counters of the guarded queries made on the calling thread. Each thread keeps its
+	// own, so threads querying at once never contend over them.
+	inline guard_stats& guard_statistics()
+	{
+		thread_local guard_stats stats;
+		return stats;
+	}
+
+	namespace internal
+	{
+		// Records the outcome of a bounds test, returning true if the pair was rejected
+		inline bool guard_record(const bool bRejected)
+		{
+			auto& stats = guard_statistics();
+			stats.queries++;
+			if (bRejected) stats.rejected++;
+			return bRejected;
+		}
+
+		// True if the cached bounds show the shapes can't touch
+		template<typename S1, typename S2>
+		inline bool guard_disjoint(const guarded<S1>& a, const guarded<S2>& b)
+		{
+			const double s = a.slack + b.slack;
+			if (a.box.pos.x > b.box.pos.x + b.box.size.x + s || b.box.pos.x > a.box.pos.x + a.box.size.x + s ||
+				a.box.pos.y > b.box.pos.y + b.box.size.y + s || b.box.pos.y > a.box.pos.y + a.box.size.y + s)
+				return true;
+
+			// Written so a degenerate (NaN) or absent (infinite) bounding circle never rejects
+			const double r = a.bound.radius + b.bound.radius;
+			return (a.bound.pos - b.bound.pos).mag2() > r * r;
+		}
+	}
+
+	// overlaps(ga,gb)
+	// Check if guarded shape a overlaps guarded shape b, testing bounds first
+	template<typename S1, typename S2>
+	inline bool overlaps(const guarded<S1>& a, const guarded<S2>& b)
+	{
+		if (internal::guard_record(internal::guard_disjoint(a, b))) return false;
+		return overlaps(static_cast<const S1&>(a), static_cast<const S2&>(b));
+	}
+
+	// contains(ga,gb)
+	// Check if guarded shape a contains guarded shape b, testing bounds first
+	template<typename S1, typename S2>
+	inline bool contains(const guarded<S1>& a, const guarded<S2>& b)
+	{
+		// Anything inside a lies within its bounding box
+		const double s = a.slack + b.slack;
+		const bool bOutside = b.box.pos.x + s < a.box.pos.x || b.box.pos.y + s < a.box.pos.y ||
+			b.box.pos.x + b.box.size.x > a.box.pos.x + a.box.size.x + s ||
+			b.box.pos.y + b.box.size.y > a.box.pos.y + a.box.size.y + s;
+		if (internal::guard_record(bOutside)) return false;
+		return contains(static_cast<const S1&>(a), static_cast<const S2&>(b));
+	}
+
+	// intersects(ga,gb)
+	// Get intersection points where guarded shape a intersects guarded shape b, testing bounds first
+	template<typename S1, typename S2>
+	inline auto intersects(const guarded<S1>& a, const guarded<S2>& b)
+		-> decltype(intersects(std::declval<const S1&>(), std::declval<const S2&>()))
+	{
+		if (internal::guard_record(internal::guard_disjoint(a, b))) return {};
+		return intersects(static_cast<const S1&>(a), static_cast<const S2&>(b));
+	}
+
+	// project(c,gs,q)
+	// project a circle, onto a guarded shape, via a ray, testing the path against its bounds first
+	template<typename T1, typename S2, typename T3>
+	inline auto project(const circle<T1>& c, const guarded<S2>& s, const ray<T3>& q)
+		-> decltype(project(c, std::declval<const S2&>(), q))
+	{
+		// The circle's path must enter the bounding box, inflated by the radius
+		const olc::v_2d<double> vRadius = { double(c.radius) + s.slack, double(c.radius) + s.slack };
+		const olc::v_2d<double> vMin = s.box.pos - vRadius;
+		const olc::v_2d<double> vMax = s.box.pos + s.box.size + vRadius;
+		double t0 = 0.0, t1 = std::numeric_limits<double>::infinity();
+		const bool bMiss = !internal::clip_to_box(olc::v_2d<double>(q.origin), olc::v_2d<double>(q.direction), vMin, vMax, t0, t1);
+
+		if (internal::guard_record(bMiss)) return std::nullopt;
+		return project(c, static_cast<const S2&>(s), q);
+	}
+
+	// POLYGONS =============================================================================================================
+
+	// Functions taking a polygon assume it is convex, and test it against other shapes using
+	// the separating axis theorem: two convex shapes overlap unless a side of one of them has
+	// the other entirely outside it. A prepared_polygon caches its side normals and extents,
+	// so one polygon tested against many shapes only computes them once.
+
+	namespace internal
+	{
+		// Outward normals of the sides of a convex outline, computed as needed. A line is
+		// an outline of two points whose two "sides" face opposite ways, and a point has
+		// a single side of zero length that never separates anything.
+		template<typename T>
+		struct convex_edges
+		{
+			const olc::v_2d<T>* pos = nullptr;
+			size_t n = 0;
+			double winding = 1.0;
+
+			inline convex_edges(const olc::v_2d<T>* p, const size_t count)
+				: pos(p), n(count)
+			{
+				double dArea = 0.0;
+				for (size_t i = 0; i < n; i++)
+					dArea += olc::v_2d<double>(pos[i]).cross(olc::v_2d<double>(pos[(i + 1) % n]));
+				winding = dArea < 0.0 ? -1.0 : 1.0;
+			}
+
+			inline size_t count() const { return n; }
+			inline olc::v_2d<double> vertex(const size_t i) const { return pos[i]; }
+			inline olc::v_2d<double> normal(const size_t i) const { return -(olc::v_2d<double>(pos[(i + 1) % n]) - olc::v_2d<double>(pos[i])).perp() * winding; }
+			inline double offset(const size_t i) const { return normal(i).dot(vertex(i)); }
+		};
+
+		// As convex_edges, but reading the values cached by a prepared polygon
+		template<typename T>
+		struct prepared_edges
+		{
+			const prepared_polygon<T>& p;
+
+			inline size_t count() const { return p.pos.size(); }
+			inline olc::v_2d<double> vertex(const size_t i) const { return p.pos[i]; }
+			inline olc::v_2d<double> normal(const size_t i) const { return p.normal[i]; }
+			inline double offset(const size_t i) const { return p.proj_max[i]; }
+		};
+
+		template<typename T>
+		inline std::array<olc::v_2d<T>, 4> rect_corners(const rect<T>& r)
+		{
+			return { r.pos, r.pos + olc::v_2d<T>(r.size.x, 0), r.pos + r.size, r.pos + olc::v_2d<T>(0, r.size.y) };
+		}
+
+		// True if a side of outline a has all of outline b strictly outside it
+		template<typename E1, typename E2>
+		inline bool separated_by_sides(const E1& a, const E2& b)
+		{
+			for (size_t i = 0; i < a.count(); i++)
+			{
+				const auto n = a.normal(i);
+				const double o = a.offset(i);
+				bool bOutside = true;
+				for (size_t j = 0; j < b.count() && bOutside; j++)
+					bOutside = n.dot(b.vertex(j)) > o;
+				if (bOutside) return true;
+			}
+			return false;
+		}
+
+		// Separating axis test of two convex outlines
+		template<typename E1, typename E2>
+		inline bool overlaps_convex(const E1& a, const E2& b)
+		{
+			return !separated_by_sides(a, b) && !separated_by_sides(b, a);
+		}
+
+		// True if point is within or on every side of convex outline
+		template<typename E, typename T>
+		inline bool contains_convex(const E& a, const olc::v_2d<T>& p)
+		{
+			// Measured from the side's start rather than against its offset, so the polygon's
+			// own vertices are exactly on its sides
+			const olc::v_2d<double> v = p;
+			for (size_t i = 0; i < a.count(); i++)
+				if (a.normal(i).dot(v - a.vertex(i)) > 0.0) return false;
+			return true;
+		}
+
+		// True if every vertex of outline b is within convex outline a
+		template<typename E1, typename E2>
+		inline bool contains_convex_outline(const E1& a, const E2& b)
+		{
+			for (size_t j = 0; j < b.count(); j++)
+				if (!contains_convex(a, b.vertex(j))) return false;
+			return true;
+		}
+
+		// True if circle is within or on every side of convex outline
+		template<typename E, typename T>
+		inline bool contains_convex(const E& a, const circle<T>& c)
+		{
+			const olc::v_2d<double> v = c.pos;
+			const double r2 = double(c.radius) * double(c.radius);
+			for (size_t i = 0; i < a.count(); i++)
+			{
+				// Normals aren't normalised, so compare squared distance scaled by their length
+				const auto n = a.normal(i);
+				const double d = a.offset(i) - n.dot(v);
+				if (d < 0.0 || d * d < r2 * n.mag2()) return false;
+			}
+			return true;
+		}
+
+		// Closest point on the boundary of convex outline to point
+		template<typename E, typename T>
+		inline olc::v_2d<double> closest_convex(const E& a, const olc::v_2d<T>& p)
+		{
+			const olc::v_2d<double> v = p;
+			olc::v_2d<double> vClosest = a.count() > 0 ? a.vertex(0) : v;
+			double dClosest = std::numeric_limits<double>::max();
+			for (size_t i = 0; i < a.count(); i++)
+			{
+				const auto s = a.vertex(i);
+				const auto d = a.vertex((i + 1) % a.count()) - s;
+				const double d2 = d.mag2();
+				const double u = d2 > 0.0 ? std::clamp(d.dot(v - s) / d2, 0.0, 1.0) : 0.0;
+				const auto c = s + d * u;
+				const double dist = (c - v).mag2();
+				if (dist < dClosest) { dClosest = dist; vClosest = c; }
+			}
+			return vClosest;
+		}
+
+		// Closest point on the sides of shape a to the sides of shape b
+		template<typename S1, typename S2>
+		inline auto closest_between_sides(const S1& a, const S2& b)
+		{
+			decltype(a.side(0).start) vClosest{};
+			double dClosest = std::numeric_limits<double>::max();
+			for (size_t i = 0; i < a.side_count(); i++)
+			{
+				const auto sa = a.side(i);
+				for (size_t j = 0; j < b.side_count(); j++)
+				{
+					const auto sb = b.side(j);
+					const auto p = closest(sa, sb);
+					const double d = (closest(sb, p) - p).mag2();
+					if (d < dClosest) { dClosest = d; vClosest = p; }
+				}
+			}
+			return vClosest;
+		}
+
+		// Boundary intersections of polygon with any shape that intersects line segments
+		template<typename T1, typename S2, typename T2>
+		inline std::vector<olc::v_2d<T2>> intersects_sides(const polygon<T1>& g, const S2& s)
+		{
+			std::vector<olc::v_2d<T2>> intersections;
+			for (size_t i = 0; i < g.side_count(); i++)
+			{
+				auto v = intersects(g.side(i), s);
+				intersections.insert(intersections.end(), v.begin(), v.end());
+			}
+			return filter_duplicate_points(intersections);
+		}
+	}
+
+
+	// overlaps(poly,p)
+	// Checks if point is within or on convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const polygon<T1>& g, const olc::v_2d<T2>& p)
+	{
+		return contains(g, p);
+	}
+
+	// overlaps(poly,l)
+	// Checks if line segment overlaps convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const polygon<T1>& g, const line<T2>& l)
+	{
+		const std::array<olc::v_2d<T2>, 2> vLine = { l.start, l.end };
+		return internal::overlaps_convex(internal::convex_edges<T1>(g.pos.data(), g.pos.size()), internal::convex_edges<T2>(vLine.data(), 2));
+	}
+
+	// overlaps(poly,r)
+	// Checks if rectangle overlaps convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const polygon<T1>& g, const rect<T2>& r)
+	{
+		const auto vCorners = internal::rect_corners(r);
+		return internal::overlaps_convex(internal::convex_edges<T1>(g.pos.data(), g.pos.size()), internal::convex_edges<T2>(vCorners.data(), 4));
+	}
+
+	// overlaps(poly,c)
+	// Checks if circle overlaps convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const polygon<T1>& g, const circle<T2>& c)
+	{
+		const internal::convex_edges<T1> e(g.pos.data(), g.pos.size());
+		return internal::contains_convex(e, c.pos)
+			|| (internal::closest_convex(e, c.pos) - olc::v_2d<double>(c.pos)).mag2() <= double(c.radius) * double(c.radius);
+	}
+
+	// overlaps(poly,t)
+	// Checks if triangle overlaps convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const polygon<T1>& g, const triangle<T2>& t)
+	{
+		return internal::overlaps_convex(internal::convex_edges<T1>(g.pos.data(), g.pos.size()), internal::convex_edges<T2>(t.pos.data(), 3));
+	}
+
+	// overlaps(poly,poly)
+	// Checks if convex polygon overlaps convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const polygon<T1>& g1, const polygon<T2>& g2)
+	{
+		return internal::overlaps_convex(internal::convex_edges<T1>(g1.pos.data(), g1.pos.size()), internal::convex_edges<T2>(g2.pos.data(), g2.pos.size()));
+	}
+
+	// overlaps(p,poly)
+	// Checks if point is within or on convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const olc::v_2d<T1>& p, const polygon<T2>& g)
+	{
+		return overlaps(g, p);
+	}
+
+	// overlaps(l,poly)
+	// Checks if line segment overlaps convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const line<T1>& l, const polygon<T2>& g)
+	{
+		return overlaps(g, l);
+	}
+
+	// overlaps(r,poly)
+	// Checks if rectangle overlaps convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const rect<T1>& r, const polygon<T2>& g)
+	{
+		return overlaps(g, r);
+	}
+
+	// overlaps(c,poly)
+	// Checks if circle overlaps convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const circle<T1>& c, const polygon<T2>& g)
+	{
+		return overlaps(g, c);
+	}
+
+	// overlaps(t,poly)
+	// Checks if triangle overlaps convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const triangle<T1>& t, const polygon<T2>& g)
+	{
+		return overlaps(g, t);
+	}
+
+
+	// contains(poly,p)
+	// Checks if convex polygon contains point
+	template<typename T1, typename T2>
+	inline bool contains(const polygon<T1>& g, const olc::v_2d<T2>& p)
+	{
+		if (g.pos.size() < 3) return false;
+		return internal::contains_convex(internal::convex_edges<T1>(g.pos.data(), g.pos.size()), p);
+	}
+
+	// contains(poly,l)
+	// Checks if convex polygon contains line segment
+	template<typename T1, typename T2>
+	inline bool contains(const polygon<T1>& g, const line<T2>& l)
+	{
+		if (g.pos.size() < 3) return false;
+		const internal::convex_edges<T1> e(g.pos.data(), g.pos.size());
+		return internal::contains_convex(e, l.start) && internal::contains_convex(e, l.end);
+	}
+
+	// contains(poly,r)
+	// Checks if convex polygon contains rectangle
+	template<typename T1, typename T2>
+	inline bool contains(const polygon<T1>& g, const rect<T2>& r)
+	{
+		if (g.pos.size() < 3) return false;
+		const auto vCorners = internal::rect_corners(r);
+		return internal::contains_convex_outline(internal::convex_edges<T1>(g.pos.data(), g.pos.size()), internal::convex_edges<T2>(vCorners.data(), 4));
+	}
+
+	// contains(poly,c)
+	// Checks if convex polygon contains circle
+	template<typename T1, typename T2>
+	inline bool contains(const polygon<T1>& g, const circle<T2>& c)
+	{
+		if (g.pos.size() < 3) return false;
+		return internal::contains_convex(internal::convex_edges<T1>(g.pos.data(), g.pos.size()), c);
+	}
+
+	// contains(poly,t)
+	// Checks if convex polygon contains triangle
+	template<typename T1, typename T2>
+	inline bool contains(const polygon<T1>& g, const triangle<T2>& t)
+	{
+		if (g.pos.size() < 3) return false;
+		return internal::contains_convex_outline(internal::convex_edges<T1>(g.pos.data(), g.pos.size()), internal::convex_edges<T2>(t.pos.data(), 3));
+	}
+
+	// contains(poly,poly)
+	// Checks if convex polygon contains polygon
+	template<typename T1, typename T2>
+	inline bool contains(const polygon<T1>& g1, const polygon<T2>& g2)
+	{
+		if (g1.pos.size() < 3) return false;
+		return internal::contains_convex_outline(internal::convex_edges<T1>(g1.pos.data(), g1.pos.size()), internal::convex_edges<T2>(g2.pos.data(), g2.pos.size()));
+	}
+
+	// contains(r,poly)
+	// Checks if rectangle contains polygon
+	template<typename T1, typename T2>
+	inline bool contains(const rect<T1>& r, const polygon<T2>& g)
+	{
+		return std::all_of(g.pos.begin(), g.pos.end(), [&](const auto& p) { return contains(r, p); });
+	}
+
+	// contains(c,poly)
+	// Checks if circle contains polygon
+	template<typename T1, typename T2>
+	inline bool contains(const circle<T1>& c, const polygon<T2>& g)
+	{
+		return std::all_of(g.pos.begin(), g.pos.end(), [&](const auto& p) { return contains(c, p); });
+	}
+
+	// contains(t,poly)
+	// Checks if triangle contains polygon
+	template<typename T1, typename T2>
+	inline bool contains(const triangle<T1>& t, const polygon<T2>& g)
+	{
+		return std::all_of(g.pos.begin(), g.pos.end(), [&](const auto& p) { return contains(t, p); });
+	}
+
+
+	// intersects(poly,p)
+	// Get intersection points where point intersects with polygon boundary
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T2>> intersects(const polygon<T1>& g, const olc::v_2d<T2>& p)
+	{
+		return internal::intersects_sides<T1, olc::v_2d<T2>, T2>(g, p);
+	}
+
+	// intersects(poly,l)
+	// Get intersection points where line segment intersects with polygon boundary
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T2>> intersects(const polygon<T1>& g, const line<T2>& l)
+	{
+		return internal::intersects_sides<T1, line<T2>, T2>(g, l);
+	}
+
+	// intersects(poly,r)
+	// Get intersection points where rectangle intersects with polygon boundary
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T2>> intersects(const polygon<T1>& g, const rect<T2>& r)
+	{
+		return internal::intersects_sides<T1, rect<T2>, T2>(g, r);
+	}
+
+	// intersects(poly,c)
+	// Get intersection points where circle intersects with polygon boundary
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T2>> intersects(const polygon<T1>& g, const circle<T2>& c)
+	{
+		return internal::intersects_sides<T1, circle<T2>, T2>(g, c);
+	}
+
+	// intersects(poly,t)
+	// Get intersection points where triangle intersects with polygon boundary
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T2>> intersects(const polygon<T1>& g, const triangle<T2>& t)
+	{
+		return internal::intersects_sides<T1, triangle<T2>, T2>(g, t);
+	}
+
+	// intersects(poly,poly)
+	// Get intersection points where polygon boundary intersects with polygon boundary
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T2>> intersects(const polygon<T1>& g1, const polygon<T2>& g2)
+	{
+		std::vector<olc::v_2d<T2>> intersections;
+		for (size_t i = 0; i < g2.side_count(); i++)
+		{
+			auto v = intersects(g1, g2.side(i));
+			intersections.insert(intersections.end(), v.begin(), v.end());
+		}
+		return internal::filter_duplicate_points(intersections);
+	}
+
+	// intersects(p,poly)
+	// Get intersection points where point intersects with polygon boundary
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T1>> intersects(const olc::v_2d<T1>& p, const polygon<T2>& g)
+	{
+		return intersects(g, p);
+	}
+
+	// intersects(l,poly)
+	// Get intersection points where line segment intersects with polygon boundary
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T1>> intersects(const line<T1>& l, const polygon<T2>& g)
+	{
+		return intersects(g, l);
+	}
+
+	// intersects(r,poly)
+	// Get intersection points where rectangle intersects with polygon boundary
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T1>> intersects(const rect<T1>& r, const polygon<T2>& g)
+	{
+		return intersects(g, r);
+	}
+
+	// intersects(c,poly)
+	// Get intersection points where circle intersects with polygon boundary
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T1>> intersects(const circle<T1>& c, const polygon<T2>& g)
+	{
+		return intersects(g, c);
+	}
+
+	// intersects(t,poly)
+	// Get intersection points where triangle intersects with polygon boundary
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T1>> intersects(const triangle<T1>& t, const polygon<T2>& g)
+	{
+		return intersects(g, t);
+	}
+
+
+	// closest(poly,p)
+	// Returns closest point on polygon boundary to point
+	template<typename T1, typename T2>
+	inline olc::v_2d<T1> closest(const polygon<T1>& g, const olc::v_2d<T2>& p)
+	{
+		return internal::closest_convex(internal::convex_edges<T1>(g.pos.data(), g.pos.size()), p);
+	}
+
+	// closest(poly,l)
+	// Returns closest point on polygon boundary to line segment
+	template<typename T1, typename T2>
+	inline olc::v_2d<T1> closest(const polygon<T1>& g, const line<T2>& l)
+	{
+		olc::v_2d<T1> vClosest;
+		double dClosest = std::numeric_limits<double>::max();
+		for (size_t i = 0; i < g.side_count(); i++)
+		{
+			const auto p = closest(g.side(i), l);
+			const double d = (closest(l, p) - p).mag2();
+			if (d < dClosest) { dClosest = d; vClosest = p; }
+		}
+		return vClosest;
+	}
+
+	// closest(poly,r)
+	// Returns closest point on polygon boundary to rectangle
+	template<typename T1, typename T2>
+	inline olc::v_2d<T1> closest(const polygon<T1>& g, const rect<T2>& r)
+	{
+		return internal::closest_between_sides(g, r);
+	}
+
+	// closest(poly,c)
+	// Returns closest point on polygon boundary to circle
+	template<typename T1, typename T2>
+	inline olc::v_2d<T1> closest(const polygon<T1>& g, const circle<T2>& c)
+	{
+		return closest(g, c.pos);
+	}
+
+	// closest(poly,t)
+	// Returns closest point on polygon boundary to triangle
+	template<typename T1, typename T2>
+	inline olc::v_2d<T1> closest(const polygon<T1>& g, const triangle<T2>& t)
+	{
+		return internal::closest_between_sides(g, t);
+	}
+
+	// closest(poly,poly)
+	// Returns closest point on polygon boundary to polygon
+	template<typename T1, typename T2>
+	inline olc::v_2d<T1> closest(const polygon<T1>& g1, const polygon<T2>& g2)
+	{
+		return internal::closest_between_sides(g1, g2);
+	}
+
+
+	// Prepared polygons test their cached side normals first, and their cached bounding box
+	// rejects distant shapes before any of that
+
+	// contains(ppoly,p)
+	// Checks if prepared convex polygon contains point
+	template<typename T1, typename T2>
+	inline bool contains(const prepared_polygon<T1>& g, const olc::v_2d<T2>& p)
+	{
+		if (g.pos.size() < 3 || p.x < g.box_min.x || p.y < g.box_min.y || p.x > g.box_max.x || p.y > g.box_max.y) return false;
+		return internal::contains_convex(internal::prepared_edges<T1>{ g }, p);
+	}
+
+	// overlaps(ppoly,p)
+	// Checks if point is within or on prepared convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const prepared_polygon<T1>& g, const olc::v_2d<T2>& p)
+	{
+		return contains(g, p);
+	}
+
+	// contains(ppoly,l)
+	// Checks if prepared convex polygon contains line segment
+	template<typename T1, typename T2>
+	inline bool contains(const prepared_polygon<T1>& g, const line<T2>& l)
+	{
+		return contains(g, l.start) && contains(g, l.end);
+	}
+
+	// overlaps(ppoly,l)
+	// Checks if line segment overlaps prepared convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const prepared_polygon<T1>& g, const line<T2>& l)
+	{
+		if (!overlaps(rect<T1>(g.box_min, g.box_max - g.box_min), envelope_r(l))) return false;
+		const std::array<olc::v_2d<T2>, 2> vLine = { l.start, l.end };
+		return internal::overlaps_convex(internal::prepared_edges<T1>{ g }, internal::convex_edges<T2>(vLine.data(), 2));
+	}
+
+	// contains(ppoly,r)
+	// Checks if prepared convex polygon contains rectangle
+	template<typename T1, typename T2>
+	inline bool contains(const prepared_polygon<T1>& g, const rect<T2>& r)
+	{
+		if (g.pos.size() < 3) return false;
+		const auto vCorners = internal::rect_corners(r);
+		return internal::contains_convex_outline(internal::prepared_edges<T1>{ g }, internal::convex_edges<T2>(vCorners.data(), 4));
+	}
+
+	// overlaps(ppoly,r)
+	// Checks if rectangle overlaps prepared convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const prepared_polygon<T1>& g, const rect<T2>& r)
+	{
+		// The bounding box test is the rectangle's half of the separating axis test
+		if (!overlaps(rect<T1>(g.box_min, g.box_max - g.box_min), r)) return false;
+		const auto vCorners = internal::rect_corners(r);
+		return !internal::separated_by_sides(internal::prepared_edges<T1>{ g }, internal::convex_edges<T2>(vCorners.data(), 4));
+	}
+
+	// contains(ppoly,c)
+	// Checks if prepared convex polygon contains circle
+	template<typename T1, typename T2>
+	inline bool contains(const prepared_polygon<T1>& g, const circle<T2>& c)
+	{
+		if (g.pos.size() < 3) return false;
+		return internal::contains_convex(internal::prepared_edges<T1>{ g }, c);
+	}
+
+	// overlaps(ppoly,c)
+	// Checks if circle overlaps prepared convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const prepared_polygon<T1>& g, const circle<T2>& c)
+	{
+		// Box test counts touching as overlapping, as the exact test below does
+		const olc::v_2d<double> vNear = olc::v_2d<double>(c.pos).clamp(olc::v_2d<double>(g.box_min), olc::v_2d<double>(g.box_max));
+		if ((vNear - olc::v_2d<double>(c.pos)).mag2() > double(c.radius) * double(c.radius)) return false;
+		const internal::prepared_edges<T1> e{ g };
+		return internal::contains_convex(e, c.pos)
+			|| (internal::closest_convex(e, c.pos) - olc::v_2d<double>(c.pos)).mag2() <= double(c.radius) * double(c.radius);
+	}
+
+	// contains(ppoly,t)
+	// Checks if prepared convex polygon contains triangle
+	template<typename T1, typename T2>
+	inline bool contains(const prepared_polygon<T1>& g, const triangle<T2>& t)
+	{
+		if (g.pos.size() < 3) return false;
+		return internal::contains_convex_outline(internal::prepared_edges<T1>{ g }, internal::convex_edges<T2>(t.pos.data(), 3));
+	}
+
+	// overlaps(ppoly,t)
+	// Checks if triangle overlaps prepared convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const prepared_polygon<T1>& g, const triangle<T2>& t)
+	{
+		if (!overlaps(rect<T1>(g.box_min, g.box_max - g.box_min), envelope_r(t))) return false;
+		return internal::overlaps_convex(internal::prepared_edges<T1>{ g }, internal::convex_edges<T2>(t.pos.data(), 3));
+	}
+
+	// contains(ppoly,poly)
+	// Checks if prepared convex polygon contains polygon
+	template<typename T1, typename T2>
+	inline bool contains(const prepared_polygon<T1>& g1, const polygon<T2>& g2)
+	{
+		if (g1.pos.size() < 3) return false;
+		return internal::contains_convex_outline(internal::prepared_edges<T1>{ g1 }, internal::convex_edges<T2>(g2.pos.data(), g2.pos.size()));
+	}
+
+	// overlaps(ppoly,poly)
+	// Checks if convex polygon overlaps prepared convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const prepared_polygon<T1>& g1, const polygon<T2>& g2)
+	{
+		return internal::overlaps_convex(internal::prepared_edges<T1>{ g1 }, internal::convex_edges<T2>(g2.pos.data(), g2.pos.size()));
+	}
+
+	// overlaps(ppoly,ppoly)
+	// Checks if prepared convex polygon overlaps prepared convex polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const prepared_polygon<T1>& g1, const prepared_polygon<T2>& g2)
+	{
+		if (g1.box_max.x < g2.box_min.x || g1.box_max.y < g2.box_min.y || g2.box_max.x < g1.box_min.x || g2.box_max.y < g1.box_min.y) return false;
+		return internal::overlaps_convex(internal::prepared_edges<T1>{ g1 }, internal::prepared_edges<T2>{ g2 });
+	}
+
+
+	// envelope_r(poly)
+	// Return rectangle that fully encapsulates a polygon
+	template<typename T1>
+	inline rect<T1> envelope_r(const polygon<T1>& g)
+	{
+		if (g.pos.empty()) return {};
+		olc::v_2d<T1> vMin = g.pos[0], vMax = g.pos[0];
+		for (const auto& p : g.pos)
+		{
+			vMin = vMin.min(p);
+			vMax = vMax.max(p);
+		}
+		return rect<T1>(vMin, vMax - vMin);
+	}
+
+	// envelope_c(poly)
+	// Return circle that fully encapsulates a polygon
+	template<typename T1>
+	inline circle<T1> envelope_c(const polygon<T1>& g)
+	{
+		const auto r = envelope_r(g);
+		const olc::v_2d<T1> vCentre = r.pos + r.size / T1(2);
+		double dRadius2 = 0.0;
+		for (const auto& p : g.pos)
+			dRadius2 = std::max(dRadius2, double((p - vCentre).mag2()));
+		return { vCentre, T1(std::sqrt(dRadius2)) };
+	}
+
+	// INDEXED POLYGONS =====================================================================================================
+
+	// For large polygons, including concave ones, queried by many points. The sides are
+	// held in an interval tree over y, so finding the sides level with a point, and thus
+	// whether the point is inside by counting crossings, is O(log n + k) rather than O(n),
+	// k being the number of sides at that height.
+	//
+	// An indexed_polygon is not a polygon to other functions, as most of those assume
+	// convex shapes; its points are still available as pos.
+
+	template<typename T>
+	struct indexed_polygon : private polygon<T>
+	{
+		using polygon<T>::pos;
+		using polygon<T>::side;
+		using polygon<T>::side_count;
+
+		// Interval tree node, holding the sides that span its centre. Sides wholly below
+		// and above the centre are in the child nodes, -1 if there are none.
+		struct node
+		{
+			double centre = 0.0;
+			uint32_t first = 0;
+			uint32_t count = 0;
+			int32_t below = -1;
+			int32_t above = -1;
+		};
+
+		std::vector<node> nodes;
+		// Per node, the side indices spanning its centre, sorted by lowest y ascending
+		std::vector<uint32_t> by_lowest;
+		// Per node, the same side indices sorted by highest y descending
+		std::vector<uint32_t> by_highest;
+		// Lowest and highest y of each side
+		std::vector<double> side_lo;
+		std::vector<double> side_hi;
+		// Corners of bounding box
+		olc::v_2d<T> box_min;
+		olc::v_2d<T> box_max;
+
+		inline indexed_polygon(const polygon<T>& p = {})
+			: polygon<T>(p)
+		{
+			rebuild();
+		}
+
+		// Rebuilds the index after pos has changed, reusing its storage
+		inline void rebuild()
+		{
+			const auto& v = this->pos;
+			const size_t n = v.size();
+			nodes.clear();
+			by_lowest.clear();
+			by_highest.clear();
+			side_lo.resize(n);
+			side_hi.resize(n);
+			if (n == 0) return;
+
+			box_min = box_max = v[0];
+			for (size_t i = 0; i < n; i++)
+			{
+				const double y0 = v[i].y, y1 = v[(i + 1) % n].y;
+				side_lo[i] = std::min(y0, y1);
+				side_hi[i] = std::max(y0, y1);
+				box_min = box_min.min(v[i]);
+				box_max = box_max.max(v[i]);
+			}
+
+			sides.resize(n);
+			for (size_t i = 0; i < n; i++) sides[i] = uint32_t(i);
+			build(0, uint32_t(n));
+		}
+
+	private:
+		// Side indices being sorted into the tree
+		std::vector<uint32_t> sides;
+
+		// Builds the subtree for sides [first, last), returning its node index. Depth is
+		// logarithmic, as each node takes the median side.
+		inline int32_t build(const uint32_t first, const uint32_t last)
+		{
+			if (first == last) return -1;
+
+			auto mid = [&](const uint32_t s) { return side_lo[s] + side_hi[s]; };
+			const auto itFirst = sides.begin() + first, itLast = sides.begin() + last;
+			std::nth_element(itFirst, itFirst + (last - first) / 2, itLast,
+				[&](const uint32_t a, const uint32_t b) { return mid(a) < mid(b); });
+			const double dCentre = mid(sides[first + (last - first) / 2]) * 0.5;
+
+			// In place as below, then spanning, then above the centre
+			const auto itSpanning = std::partition(itFirst, itLast, [&](const uint32_t s) { return side_hi[s] < dCentre; });
+			const auto itAbove = std::partition(itSpanning, itLast, [&](const uint32_t s) { return side_lo[s] <= dCentre; });
+
+			const int32_t nNode = int32_t(nodes.size());
+			nodes.push_back({ dCentre, uint32_t(by_lowest.size()), uint32_t(itAbove - itSpanning) });
+
+			std::sort(itSpanning, itAbove, [&](const uint32_t a, const uint32_t b) { return side_lo[a] < side_lo[b]; });
+			by_lowest.insert(by_lowest.end(), itSpanning, itAbove);
+			std::sort(itSpanning, itAbove, [&](const uint32_t a, const uint32_t b) { return side_hi[a] > side_hi[b]; });
+			by_highest.insert(by_highest.end(), itSpanning, itAbove);
+
+			const int32_t nBelow = build(first, uint32_t(itSpanning - sides.begin()));
+			const int32_t nAbove = build(uint32_t(itAbove - sides.begin()), last);
+			nodes[nNode].below = nBelow;
+			nodes[nNode].above = nAbove;
+			return nNode;
+		}
+	};
+
+	namespace internal
+	{
+		// Crossing test of one polygon side against a horizontal ray heading right from p.
+		// Returns true if checking the boundary, and p lies on the side itself.
+		template<typename T1, typename T2>
+		inline bool cross_side(const indexed_polygon<T1>& g, const uint32_t s, const olc::v_2d<T2>& p, const bool bBoundary, bool& bInside)
+		{
+			const auto& a = g.pos[s];
+			const auto& b = g.pos[(s + 1) % g.pos.size()];
+			if (bBoundary && contains(line<T1>(a, b), p)) return true;
+
+			// Half open in y, so a vertex shared by two sides is counted once
+			if ((a.y > p.y) != (b.y > p.y))
+			{
+				const double x = a.x + (double(p.y) - a.y) * (double(b.x) - a.x) / (double(b.y) - a.y);
+				if (double(p.x) < x) bInside = !bInside;
+			}
+			return false;
+		}
+
+		// Crossing count of point against the sides level with it. With bBoundary set, points
+		// on a side are inside, otherwise they go whichever way the crossing count says.
+		template<typename T1, typename T2>
+		inline bool indexed_contains(const indexed_polygon<T1>& g, const olc::v_2d<T2>& p, const bool bBoundary)
+		{
+			if (g.nodes.empty() || p.x < g.box_min.x || p.y < g.box_min.y || p.x > g.box_max.x || p.y > g.box_max.y)
+				return false;
+
+			const double y = p.y;
+			bool bInside = false;
+			int32_t n = 0;
+			while (n >= 0)
+			{
+				const auto& nd = g.nodes[n];
+				const uint32_t nEnd = nd.first + nd.count;
+				if (y < nd.centre)
+				{
+					// Spanning sides reach at least as high as the centre, so only need to start below y
+					for (uint32_t i = nd.first; i < nEnd && g.side_lo[g.by_lowest[i]] <= y; i++)
+						if (cross_side(g, g.by_lowest[i], p, bBoundary, bInside)) return true;
+					n = nd.below;
+				}
+				else if (y > nd.centre)
+				{
+					for (uint32_t i = nd.first; i < nEnd && g.side_hi[g.by_highest[i]] >= y; i++)
+						if (cross_side(g, g.by_highest[i], p, bBoundary, bInside)) return true;
+					n = nd.above;
+				}
+				else
+				{
+					for (uint32_t i = nd.first; i < nEnd; i++)
+						if (cross_side(g, g.by_lowest[i], p, bBoundary, bInside)) return true;
+					n = -1;
+				}
+			}
+			return bInside;
+		}
+	}
+
+	// contains(ipoly,p)
+	// Checks if indexed polygon, which may be concave, contains point. Boundary counts as inside.
+	template<typename T1, typename T2>
+	inline bool contains(const indexed_polygon<T1>& g, const olc::v_2d<T2>& p)
+	{
+		return internal::indexed_contains(g, p, true);
+	}
+
+	// overlaps(ipoly,p)
+	// Checks if point is within or on indexed polygon
+	template<typename T1, typename T2>
+	inline bool overlaps(const indexed_polygon<T1>& g, const olc::v_2d<T2>& p)
+	{
+		return contains(g, p);
+	}
+
+	// contains(ipoly,vp)
+	// Checks which of many points indexed polygon contains, results[i] for points[i]
+	template<typename T1, typename T2>
+	inline std::vector<bool> contains(const indexed_polygon<T1>& g, const std::vector<olc::v_2d<T2>>& points)
+	{
+		std::vector<bool> results(points.size());
+		for (size_t i = 0; i < points.size(); i++)
+			results[i] = contains(g, points[i]);
+		return results;
+	}
+
+	// CONVEX HULL ==========================================================================================================
+
+	namespace internal
+	{
+		// Inputs larger than this are split across threads, hulled in parts, and merged
+		inline constexpr size_t hull_parallel_threshold = 100000;
+
+		// Cross product of (b - a) and (c - a), positive when a, b, c turn positively
+		template<typename T>
+		inline double turn(const olc::v_2d<T>& a, const olc::v_2d<T>& b, const olc::v_2d<T>& c)
+		{
+			return (double(b.x) - a.x) * (double(c.y) - a.y) - (double(b.y) - a.y) * (double(c.x) - a.x);
+		}
+
+		// Akl-Toussaint heuristic - points strictly inside the polygon formed by the extreme
+		// points in eight directions can't be on the hull, so are dropped before sorting
+		template<typename T>
+		inline void hull_filter(const olc::v_2d<T>* points, const size_t count, std::vector<olc::v_2d<T>>& out)
+		{
+			if (count == 0) return;
+
+			// Extremes along directions at 45 degree steps, which are in convex order
+			constexpr int dx[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+			constexpr int dy[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+			std::array<olc::v_2d<T>, 8> vExtreme;
+			std::array<double, 8> dExtreme;
+			vExtreme.fill(points[0]);
+			for (size_t k = 0; k < 8; k++) dExtreme[k] = dx[k] * double(points[0].x) + dy[k] * double(points[0].y);
+
+			for (size_t i = 1; i < count; i++)
+			{
+				const double x = points[i].x, y = points[i].y;
+				for (size_t k = 0; k < 8; k++)
+				{
+					const double d = dx[k] * x + dy[k] * y;
+					if (d > dExtreme[k]) { dExtreme[k] = d; vExtreme[k] = points[i]; }
+				}
+			}
+
+			// Remove repeats, so every remaining side has length
+			std::array<olc::v_2d<T>, 8> vPoly;
+			size_t nPoly = 0;
+			for (size_t k = 0; k < 8; k++)
+				if (nPoly == 0 || vExtreme[k] != vPoly[nPoly - 1]) vPoly[nPoly++] = vExtreme[k];
+			while (nPoly > 1 && vPoly[nPoly - 1] == vPoly[0]) nPoly--;
+
+			if (nPoly < 3)
+			{
+				out.insert(out.end(), points, points + count);
+				return;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				bool bInside = true;
+				for (size_t k = 0; k < nPoly && bInside; k++)
+					bInside = turn(vPoly[k], vPoly[(k + 1) % nPoly], points[i]) > 0.0;
+				if (!bInside) out.push_back(points[i]);
+			}
+		}
+
+		// Andrew's monotone chain, sorts points in place and writes hull to out
+		template<typename T>
+		inline void monotone_chain(std::vector<olc::v_2d<T>>& points, std::vector<olc::v_2d<T>>& out)
+		{
+			std::sort(points.begin(), points.end(), [](const olc::v_2d<T>& a, const olc::v_2d<T>& b)
+				{ return a.x < b.x || (a.x == b.x && a.y < b.y); });
+			points.erase(std::unique(points.begin(), points.end()), points.end());
+
+			out.clear();
+			if (points.size() < 3)
+			{
+				out.assign(points.begin(), points.end());
+				return;
+			}
+
+			out.resize(points.size() * 2);
+			size_t k = 0;
+
+			// Lower hull
+			for (size_t i = 0; i < points.size(); i++)
+			{
+				while (k >= 2 && turn(out[k - 2], out[k - 1], points[i]) <= 0.0) k--;
+				out[k++] = points[i];
+			}
+
+			// Upper hull
+			for (size_t i = points.size() - 1, t = k + 1; i > 0; i--)
+			{
+				while (k >= t && turn(out[k - 2], out[k - 1], points[i - 1]) <= 0.0) k--;
+				out[k++] = points[i - 1];
+			}
+
+			// Last point is the first point again
+			out.resize(k - 1);
+		}
+	}
+
+	// convex_hull(vp,poly)
+	// Computes the convex hull of a set of points into a polygon, reusing its storage. Points
+	// are ordered so consecutive sides turn positively (their cross product is positive), and
+	// collinear points are left out.
+	template<typename T>
+	inline void convex_hull(const std::vector<olc::v_2d<T>>& points, polygon<T>& hull)
+	{
+		std::vector<olc::v_2d<T>> vCandidates;
+
+		const size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
+		if (points.size() > internal::hull_parallel_threshold && nThreads > 1)
+		{
+			// Hull each chunk on its own thread, only the chunk hulls can be on the final hull
+			const size_t nChunk = (points.size() + nThreads - 1) / nThreads;
+			std::vector<std::vector<olc::v_2d<T>>> vChunkHulls(nThreads);
+			std::vector<std::thread> vWorkers;
+			for (size_t t = 0; t < nThreads; t++)
+			{
+				const size_t nBegin = std::min(points.size(), t * nChunk);
+				const size_t nEnd = std::min(points.size(), nBegin + nChunk);
+				vWorkers.emplace_back([&points, &vChunkHulls, t, nBegin, nEnd]()
+					{
+						std::vector<olc::v_2d<T>> vFiltered;
+						internal::hull_filter(points.data() + nBegin, nEnd - nBegin, vFiltered);
+						internal::monotone_chain(vFiltered, vChunkHulls[t]);
+					});
+			}
+
+			for (auto& w : vWorkers) w.join();
+			for (const auto& h : vChunkHulls)
+				vCandidates.insert(vCandidates.end(), h.begin(), h.end());
+		}
+		else
+		{
+			internal::hull_filter(points.data(), points.size(), vCandidates);
+		}
+
+		internal::monotone_chain(vCandidates, hull.pos);
+	}
+
+	// convex_hull(vp)
+	// Returns the convex hull of a set of points as a polygon
+	template<typename T>
+	inline polygon<T> convex_hull(const std::vector<olc::v_2d<T>>& points)
+	{
+		polygon<T> hull;
+		convex_hull(points, hull);
+		return hull;
+	}
+
+	// TRIANGULATION ========================================================================================================
+
+	// Decomposes a simple polygon, which may be concave, into triangles in O(n log n). A sweep
+	// over y adds diagonals that split the polygon into y-monotone pieces, and each piece is
+	// then triangulated in linear time.
+
+	namespace internal
+	{
+		// Sweep order, true if a is reached before b. Ties in y are broken by x, so no two
+		// distinct points are level.
+		inline bool sweep_above(const olc::v_2d<double>& a, const olc::v_2d<double>& b)
+		{
+			return a.y > b.y || (a.y == b.y && a.x < b.x);
+		}
+
+		// Orders the polygon sides held by the sweep status by their x where they cross
+		// the sweep line. Also compares directly against an x value, to find a side by it.
+		struct sweep_side_order
+		{
+			using is_transparent = void;
+
+			const std::vector<olc::v_2d<double>>* v = nullptr;
+			const olc::v_2d<double>* sweep = nullptr;
+
+			inline double x_at(const size_t e) const
+			{
+				const auto& a = (*v)[e];
+				const auto& b = (*v)[(e + 1) % v->size()];
+				if (a.y == b.y) return std::clamp(sweep->x, std::min(a.x, b.x), std::max(a.x, b.x));
+				return a.x + (sweep->y - a.y) * (b.x - a.x) / (b.y - a.y);
+			}
+
+			inline bool operator()(const size_t e1, const size_t e2) const
+			{
+				const double x1 = x_at(e1), x2 = x_at(e2);
+				return x1 < x2 || (x1 == x2 && e1 < e2);
+			}
+
+			inline bool operator()(const double x, const size_t e) const { return x < x_at(e); }
+			inline bool operator()(const size_t e, const double x) const { return x_at(e) < x; }
+		};
+
+		// Triangulates a y-monotone piece, given as indices into v turning positively.
+		// Emits triangles as index triples, also turning positively.
+		inline void triangulate_monotone(const std::vector<olc::v_2d<double>>& v, const std::vector<size_t>& vPiece,
+			std::vector<std::array<size_t, 3>>& vTris, std::vector<std::pair<size_t, bool>>& vSorted, std::vector<std::pair<size_t, bool>>& vStack)
+		{
+			const size_t k = vPiece.size();
+			if (k < 3) return;
+			if (k == 3) { vTris.push_back({ vPiece[0], vPiece[1], vPiece[2] }); return; }
+
+			size_t nTop = 0, nBottom = 0;
+			for (size_t i = 1; i < k; i++)
+			{
+				if (sweep_above(v[vPiece[i]], v[vPiece[nTop]])) nTop = i;
+				if (sweep_above(v[vPiece[nBottom]], v[vPiece[i]])) nBottom = i;
+			}
+
+			// Turning positively, the left chain runs forwards from the top, the right chain
+			// backwards. Merge both into sweep order, noting which chain each came from.
+			vSorted.clear();
+			vSorted.push_back({ vPiece[nTop], true });
+			size_t l = (nTop + 1) % k, r = (nTop + k - 1) % k;
+			while (l != nBottom || r != nBottom)
+			{
+				if (r == nBottom || (l != nBottom && sweep_above(v[vPiece[l]], v[vPiece[r]])))
+				{
+					vSorted.push_back({ vPiece[l], true });
+					l = (l + 1) % k;
+				}
+				else
+				{
+					vSorted.push_back({ vPiece[r], false });
+					r = (r + k - 1) % k;
+				}
+			}
+			vSorted.push_back({ vPiece[nBottom], true });
+
+			auto turn = [&](const size_t a, const size_t b, const size_t c)
+			{
+				return (v[b] - v[a]).cross(v[c] - v[a]);
+			};
+
+			// Emit triangle (a,b,c) in positive order, whichever way round it was found
+			auto emit = [&](const size_t a, const size_t b, const size_t c)
+			{
+				if (turn(a, b, c) >= 0.0) vTris.push_back({ a, b, c });
+				else vTris.push_back({ a, c, b });
+			};
+
+			vStack.clear();
+			vStack.push_back(vSorted[0]);
+			vStack.push_back(vSorted[1]);
+
+			for (size_t j = 2; j + 1 < k; j++)
+			{
+				const auto u = vSorted[j];
+				if (u.second != vStack.back().second)
+				{
+					// Opposite chain, so can see every stacked vertex - fan to all of them
+					for (size_t s = vStack.size() - 1; s > 0; s--)
+						emit(u.first, vStack[s].first, vStack[s - 1].first);
+					const auto last = vStack.back();
+					vStack.clear();
+					vStack.push_back(last);
+					vStack.push_back(u);
+				}
+				else
+				{
+					// Same chain, cut off vertices while the diagonal stays inside
+					auto last = vStack.back();
+					vStack.pop_back();
+					while (!vStack.empty())
+					{
+						const size_t top = vStack.back().first;
+						const double t = u.second ? turn(top, last.first, u.first) : turn(u.first, last.first, top);
+						if (t <= 0.0) break;
+						emit(u.first, last.first, top);
+						last = vStack.back();
+						vStack.pop_back();
+					}
+					vStack.push_back(last);
+					vStack.push_back(u);
+				}
+			}
+
+			// Bottom vertex sees all that remain
+			const size_t nLast = vSorted[k - 1].first;
+			for (size_t s = vStack.size() - 1; s > 0; s--)
+				emit(nLast, vStack[s].first, vStack[s - 1].first);
+		}
+	}
+
+	// triangulate(poly,vt)
+	// Decomposes simple polygon, which may be concave, into triangles appended to a caller's
+	// buffer, returning how many were added. Triangles wind the same way as the polygon.
+	template<typename T1, typename T2>
+	inline size_t triangulate(const polygon<T1>& g, std::vector<triangle<T2>>& out)
+	{
+		const size_t n = g.pos.size();
+		if (n < 3) return 0;
+
+		// Work with the points turning positively, remembering where they came from
+		double dArea = 0.0;
+		for (size_t i = 0; i < n; i++)
+			dArea += olc::v_2d<double>(g.pos[i]).cross(olc::v_2d<double>(g.pos[(i + 1) % n]));
+		const bool bReversed = dArea < 0.0;
+
+		std::vector<olc::v_2d<double>> v(n);
+		for (size_t i = 0; i < n; i++)
+			v[i] = g.pos[bReversed ? n - 1 - i : i];
+
+		// Classify vertices by their neighbours
+		enum class vertex_type : uint8_t { start, end, split, merge, regular };
+		std::vector<vertex_type> vType(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			const size_t prev = (i + n - 1) % n, next = (i + 1) % n;
+			const bool bPrevBelow = internal::sweep_above(v[i], v[prev]);
+			const bool bNextBelow = internal::sweep_above(v[i], v[next]);
+			const bool bConvex = (v[i] - v[prev]).cross(v[next] - v[i]) >= 0.0;
+			if (bPrevBelow && bNextBelow) vType[i] = bConvex ? vertex_type::start : vertex_type::split;
+			else if (!bPrevBelow && !bNextBelow) vType[i] = bConvex ? vertex_type::end : vertex_type::merge;
+			else vType[i] = vertex_type::regular;
+		}
+
+		std::vector<size_t> vEvents(n);
+		for (size_t i = 0; i < n; i++) vEvents[i] = i;
+		std::sort(vEvents.begin(), vEvents.end(), [&](const size_t a, const size_t b) { return internal::sweep_above(v[a], v[b]); });
+
+		// Sweep status holds sides (side i runs from vertex i to i + 1) with the polygon
+		// to their right, each with a helper vertex that a diagonal could be made to
+		olc::v_2d<double> vSweep;
+		std::set<size_t, internal::sweep_side_order> status(internal::sweep_side_order{ &v, &vSweep });
+		std::vector<std::set<size_t, internal::sweep_side_order>::iterator> vWhere(n, status.end());
+		std::vector<size_t> vHelper(n, 0);
+		std::vector<std::pair<size_t, size_t>> vDiagonals;
+
+		auto side_left_of = [&](const size_t i)
+		{
+			auto it = status.upper_bound(v[i].x);
+			return it == status.begin() ? status.end() : std::prev(it);
+		};
+
+		auto insert_side = [&](const size_t i)
+		{
+			vHelper[i] = i;
+			vWhere[i] = status.insert(i).first;
+		};
+
+		auto remove_side = [&](const size_t i, const size_t e)
+		{
+			if (vWhere[e] == status.end()) return;
+			if (vType[vHelper[e]] == vertex_type::merge) vDiagonals.push_back({ i, vHelper[e] });
+			status.erase(vWhere[e]);
+			vWhere[e] = status.end();
+		};
+
+		auto connect_left = [&](const size_t i, const bool bAlways)
+		{
+			const auto it = side_left_of(i);
+			if (it == status.end()) return;
+			if (bAlways || vType[vHelper[*it]] == vertex_type::merge) vDiagonals.push_back({ i, vHelper[*it] });
+			vHelper[*it] = i;
+		};
+
+		for (const size_t i : vEvents)
+		{
+			vSweep = v[i];
+			const size_t prev = (i + n - 1) % n;
+			switch (vType[i])
+			{
+			case vertex_type::start:
+				insert_side(i);
+				break;
+			case vertex_type::end:
+				remove_side(i, prev);
+				break;
+			case vertex_type::split:
+				connect_left(i, true);
+				insert_side(i);
+				break;
+			case vertex_type::merge:
+				remove_side(i, prev);
+				connect_left(i, false);
+				break;
+			case vertex_type::regular:
+				if (internal::sweep_above(v[prev], v[i]))
+				{
+					// Polygon lies to the right
+					remove_side(i, prev);
+					insert_side(i);
+				}
+				else
+					connect_left(i, false);
+				break;
+			}
+		}
+
+		// Sides and diagonals as a planar graph, each vertex's neighbours sorted by angle
+		std::vector<size_t> vOffset(n + 1, 0);
+		for (size_t i = 0; i < n; i++) vOffset[i + 1] = 2;
+		for (const auto& d : vDiagonals) { vOffset[d.first + 1]++; vOffset[d.second + 1]++; }
+		for (size_t i = 0; i < n; i++) vOffset[i + 1] += vOffset[i];
+
+		std::vector<size_t> vAdjacent(vOffset[n]);
+		std::vector<size_t> vFill(vOffset.begin(), vOffset.end() - 1);
+		for (size_t i = 0; i < n; i++)
+		{
+			const size_t next = (i + 1) % n;
+			vAdjacent[vFill[i]++] = next;
+			vAdjacent[vFill[next]++] = i;
+		}
+		for (const auto& d : vDiagonals)
+		{
+			vAdjacent[vFill[d.first]++] = d.second;
+			vAdjacent[vFill[d.second]++] = d.first;
+		}
+		for (size_t i = 0; i < n; i++)
+		{
+			std::sort(vAdjacent.begin() + vOffset[i], vAdjacent.begin() + vOffset[i + 1], [&](const size_t a, const size_t b)
+				{
+					return std::atan2(v[a].y - v[i].y, v[a].x - v[i].x) < std::atan2(v[b].y - v[i].y, v[b].x - v[i].x);
+				});
+		}
+
+		// Walk each piece with its interior on the left. Arriving at a vertex, the way
+		// on is the next neighbour clockwise from the one just left.
+		std::vector<bool> vVisited(vOffset[n], false);
+		std::vector<size_t> vPiece;
+		std::vector<std::array<size_t, 3>> vTris;
+		vTris.reserve(n - 2);
+		std::vector<std::pair<size_t, bool>> vSorted, vStack;
+
+		auto walk = [&](size_t from, size_t to)
+		{
+			vPiece.clear();
+			while (true)
+			{
+				size_t nSlot = vOffset[from];
+				while (vAdjacent[nSlot] != to) nSlot++;
+				if (vVisited[nSlot]) break;
+				vVisited[nSlot] = true;
+				vPiece.push_back(from);
+
+				size_t nBack = vOffset[to];
+				while (vAdjacent[nBack] != from) nBack++;
+				const size_t nNext = nBack == vOffset[to] ? vOffset[to + 1] - 1 : nBack - 1;
+				from = to;
+				to = vAdjacent[nNext];
+			}
+			internal::triangulate_monotone(v, vPiece, vTris, vSorted, vStack);
+		};
+
+		walk(0, 1);
+		for (const auto& d : vDiagonals)
+		{
+			walk(d.first, d.second);
+			walk(d.second, d.first);
+		}
+
+		// Back to the original points and winding
+		for (const auto& t : vTris)
+		{
+			if (bReversed)
+				out.push_back(triangle<T2>(g.pos[n - 1 - t[0]], g.pos[n - 1 - t[2]], g.pos[n - 1 - t[1]]));
+			else
+				out.push_back(triangle<T2>(g.pos[t[0]], g.pos[t[1]], g.pos[t[2]]));
+		}
+		return vTris.size();
+	}
+
+	// CLIPPING & BOOLEAN OPERATIONS ========================================================================================
+
+	// clip() cuts a polygon to a rectangle or convex polygon (Sutherland-Hodgman). A concave
+	// polygon that is cut into several parts comes back as one polygon, joined by sides
+	// running along the clipping boundary.
+	//
+	// combine() computes union, intersection or difference of two simple polygons, either
+	// of which may be concave. Every side is split where it crosses the other polygon,
+	// each part is kept or dropped depending on whether it lies inside the other polygon,
+	// and the kept parts are chained back into closed rings. The result can be several
+	// rings - outer boundaries turn positively and holes negatively.
+	//
+	// Both take an optional clip_scratch, whose storage is reused from call to call.
+
+	enum class boolean_op
+	{
+		unite,
+		intersect,
+		subtract
+	};
+
+	namespace internal
+	{
+		// A polygon side, or part of one, used by boolean operations
+		struct boolean_part
+		{
+			olc::v_2d<double> start;
+			olc::v_2d<double> end;
+			bool bUsed = false;
+		};
+
+		// Where a side is to be split, as a fraction along it, and the exact point there
+		struct boolean_split
+		{
+			uint32_t side = 0;
+			double t = 0.0;
+			olc::v_2d<double> point;
+		};
+	}
+
+	// Working storage for clip() and combine()
+	struct clip_scratch
+	{
+		std::vector<olc::v_2d<double>> ping;
+		std::vector<olc::v_2d<double>> pong;
+		std::vector<olc::v_2d<double>> a;
+		std::vector<olc::v_2d<double>> b;
+		std::vector<internal::boolean_split> splits_a;
+		std::vector<internal::boolean_split> splits_b;
+		std::vector<internal::boolean_part> parts_a;
+		std::vector<internal::boolean_part> parts_b;
+		std::vector<internal::boolean_part> kept;
+		std::vector<std::pair<uint32_t, bool>> sweep;
+		std::vector<uint32_t> active_a;
+		std::vector<uint32_t> active_b;
+		std::vector<uint32_t> order;
+		std::vector<internal::boolean_part> sorted_a;
+		std::vector<internal::boolean_part> result;
+		indexed_polygon<double> index_a;
+		indexed_polygon<double> index_b;
+	};
+
+	namespace internal
+	{
+		// Keeps the part of polygon "in" on the inner side of the line through p with outward normal n
+		inline void clip_half_plane(const std::vector<olc::v_2d<double>>& in, std::vector<olc::v_2d<double>>& out,
+			const olc::v_2d<double>& p, const olc::v_2d<double>& n)
+		{
+			out.clear();
+			if (in.empty()) return;
+
+			olc::v_2d<double> s = in.back();
+			double ds = n.dot(s - p);
+			for (const auto& e : in)
+			{
+				const double de = n.dot(e - p);
+				if ((ds <= 0.0) != (de <= 0.0))
+					out.push_back(s + (e - s) * (ds / (ds - de)));
+				if (de <= 0.0)
+					out.push_back(e);
+				s = e;
+				ds = de;
+			}
+		}
+
+		template<typename T1, typename T2>
+		inline void clip_to_planes(const polygon<T1>& subject, polygon<T1>& out, clip_scratch& scratch,
+			const olc::v_2d<T2>* planes, const size_t count, const double winding)
+		{
+			scratch.ping.assign(subject.pos.begin(), subject.pos.end());
+			for (size_t i = 0; i < count && !scratch.ping.empty(); i++)
+			{
+				const olc::v_2d<double> p = planes[i];
+				const olc::v_2d<double> q = planes[(i + 1) % count];
+				clip_half_plane(scratch.ping, scratch.pong, p, -(q - p).perp() * winding);
+				std::swap(scratch.ping, scratch.pong);
+			}
+
+			out.pos.resize(scratch.ping.size());
+			for (size_t i = 0; i < scratch.ping.size(); i++)
+				out.pos[i] = olc::v_2d<T1>(scratch.ping[i]);
+		}
+
+		// Copies polygon, turning positively
+		template<typename T>
+		inline void boolean_input(const polygon<T>& g, std::vector<olc::v_2d<double>>& out)
+		{
+			out.assign(g.pos.begin(), g.pos.end());
+			double dArea = 0.0;
+			for (size_t i = 0; i < out.size(); i++)
+				dArea += out[i].cross(out[(i + 1) % out.size()]);
+			if (dArea < 0.0) std::reverse(out.begin(), out.end());
+		}
+
+		// Records where side i of a and side j of b cross, or overlap if collinear
+		inline void boolean_cross(const std::vector<olc::v_2d<double>>& a, const uint32_t i,
+			const std::vector<olc::v_2d<double>>& b, const uint32_t j, clip_scratch& scratch)
+		{
+			const auto& a0 = a[i]; const auto& a1 = a[(i + 1) % a.size()];
+			const auto& b0 = b[j]; const auto& b1 = b[(j + 1) % b.size()];
+			const auto d1 = a1 - a0, d2 = b1 - b0, w = b0 - a0;
+			const double den = d1.cross(d2);
+
+			if (den != 0.0)
+			{
+				const double t = w.cross(d2) / den;
+				const double u = w.cross(d1) / den;
+				if (t < 0.0 || t > 1.0 || u < 0.0 || u > 1.0) return;
+
+				// Prefer an existing vertex, so both polygons agree exactly on the point
+				olc::v_2d<double> p = a0 + d1 * t;
+				if (t == 0.0) p = a0; else if (t == 1.0) p = a1;
+				if (u == 0.0) p = b0; else if (u == 1.0) p = b1;
+				scratch.splits_a.push_back({ i, t, p });
+				scratch.splits_b.push_back({ j, u, p });
+				return;
+			}
+
+			// Parallel, so only of interest if collinear. Each side is split where the other's
+			// ends lie along it, so overlapping stretches become identical parts.
+			if (w.cross(d1) != 0.0) return;
+			const double l1 = d1.mag2(), l2 = d2.mag2();
+			if (l1 == 0.0 || l2 == 0.0) return;
+			for (const auto& p : { b0, b1 })
+			{
+				const double t = (p - a0).dot(d1) / l1;
+				if (t > 0.0 && t < 1.0) scratch.splits_a.push_back({ i, t, p });
+			}
+			for (const auto& p : { a0, a1 })
+			{
+				const double u = (p - b0).dot(d2) / l2;
+				if (u > 0.0 && u < 1.0) scratch.splits_b.push_back({ j, u, p });
+			}
+		}
+
+		// Breaks sides of polygon into parts at the recorded splits
+		inline void boolean_parts(const std::vector<olc::v_2d<double>>& v, std::vector<boolean_split>& splits, std::vector<boolean_part>& parts)
+		{
+			std::sort(splits.begin(), splits.end(), [](const boolean_split& x, const boolean_split& y)
+				{ return x.side < y.side || (x.side == y.side && x.t < y.t); });
+
+			parts.clear();
+			size_t k = 0;
+			for (uint32_t i = 0; i < uint32_t(v.size()); i++)
+			{
+				olc::v_2d<double> vFrom = v[i];
+				for (; k < splits.size() && splits[k].side == i; k++)
+				{
+					if (splits[k].point == vFrom) continue;
+					parts.push_back({ vFrom, splits[k].point });
+					vFrom = splits[k].point;
+				}
+				const auto& vTo = v[(i + 1) % v.size()];
+				if (vTo != vFrom) parts.push_back({ vFrom, vTo });
+			}
+		}
+
+		inline bool boolean_point_less(const olc::v_2d<double>& a, const olc::v_2d<double>& b)
+		{
+			return a.x < b.x || (a.x == b.x && a.y < b.y);
+		}
+
+		inline bool boolean_part_less(const boolean_part& a, const boolean_part& b)
+		{
+			if (a.start != b.start) return boolean_point_less(a.start, b.start);
+			return boolean_point_less(a.end, b.end);
+		}
+
+		// Finds part going from s to e in parts sorted by boolean_part_less
+		inline bool boolean_has_part(const std::vector<boolean_part>& parts, const olc::v_2d<double>& s, const olc::v_2d<double>& e)
+		{
+			const boolean_part key{ s, e };
+			return std::binary_search(parts.begin(), parts.end(), key, boolean_part_less);
+		}
+
+		// Is part p of one polygon inside the other, given as an indexed polygon
+		inline bool boolean_inside(const boolean_part& p, const indexed_polygon<double>& other)
+		{
+			return indexed_contains(other, (p.start + p.end) * 0.5, false);
+		}
+	}
+
+	// clip(poly,r,out,s)
+	// Clips polygon to rectangle, writing result to out
+	template<typename T1, typename T2>
+	inline void clip(const polygon<T1>& subject, const rect<T2>& r, polygon<T1>& out, clip_scratch& scratch)
+	{
+		const auto vCorners = internal::rect_corners(r);
+		const double winding = (r.size.x < 0) != (r.size.y < 0) ? -1.0 : 1.0;
+		internal::clip_to_planes(subject, out, scratch, vCorners.data(), 4, winding);
+	}
+
+	// clip(poly,r)
+	// Returns polygon clipped to rectangle
+	template<typename T1, typename T2>
+	inline polygon<T1> clip(const polygon<T1>& subject, const rect<T2>& r)
+	{
+		clip_scratch scratch;
+		polygon<T1> out;
+		clip(subject, r, out, scratch);
+		return out;
+	}
+
+	// clip(poly,poly,out,s)
+	// Clips polygon to convex polygon, writing result to out
+	template<typename T1, typename T2>
+	inline void clip(const polygon<T1>& subject, const polygon<T2>& clipper, polygon<T1>& out, clip_scratch& scratch)
+	{
+		const internal::convex_edges<T2> e(clipper.pos.data(), clipper.pos.size());
+		internal::clip_to_planes(subject, out, scratch, clipper.pos.data(), clipper.pos.size(), e.winding);
+	}
+
+	// clip(poly,poly)
+	// Returns polygon clipped to convex polygon
+	template<typename T1, typename T2>
+	inline polygon<T1> clip(const polygon<T1>& subject, const polygon<T2>& clipper)
+	{
+		clip_scratch scratch;
+		polygon<T1> out;
+		clip(subject, clipper, out, scratch);
+		return out;
+	}
+
+	// combine(poly,poly,op,out,s)
+	// Computes union, intersection or difference (a - b) of two simple polygons, writing
+	// the resulting rings to out
+	template<typename T1, typename T2>
+	inline void combine(const polygon<T1>& pa, const polygon<T2>& pb, const boolean_op op, std::vector<polygon<T1>>& out, clip_scratch& scratch)
+	{
+		auto& a = scratch.a;
+		auto& b = scratch.b;
+		internal::boolean_input(pa, a);
+		internal::boolean_input(pb, b);
+		if (a.size() < 3 || b.size() < 3)
+		{
+			// Nothing to combine with
+			const bool bKeepA = a.size() >= 3 && op != boolean_op::intersect;
+			const bool bKeepB = b.size() >= 3 && op == boolean_op::unite;
+			out.clear();
+			if (bKeepA) out.push_back(pa);
+			if (bKeepB) out.push_back({ std::vector<olc::v_2d<T1>>(pb.pos.begin(), pb.pos.end()) });
+			return;
+		}
+
+		// Find crossing sides with a sweep over x, only testing sides whose x ranges overlap
+		scratch.splits_a.clear();
+		scratch.splits_b.clear();
+		auto& sweep = scratch.sweep;
+		sweep.clear();
+		for (uint32_t i = 0; i < uint32_t(a.size()); i++) sweep.push_back({ i, true });
+		for (uint32_t j = 0; j < uint32_t(b.size()); j++) sweep.push_back({ j, false });
+
+		auto side_min = [&](const std::pair<uint32_t, bool>& s) -> olc::v_2d<double>
+		{
+			const auto& v = s.second ? a : b;
+			return v[s.first].min(v[(s.first + 1) % v.size()]);
+		};
+		auto side_max = [&](const std::pair<uint32_t, bool>& s) -> olc::v_2d<double>
+		{
+			const auto& v = s.second ? a : b;
+			return v[s.first].max(v[(s.first + 1) % v.size()]);
+		};
+
+		std::sort(sweep.begin(), sweep.end(), [&](const auto& s1, const auto& s2) { return side_min(s1).x < side_min(s2).x; });
+		scratch.active_a.clear();
+		scratch.active_b.clear();
+		for (const auto& s : sweep)
+		{
+			const auto vMin = side_min(s), vMax = side_max(s);
+			auto& vOwn = s.second ? scratch.active_a : scratch.active_b;
+			auto& vOther = s.second ? scratch.active_b : scratch.active_a;
+			const auto& other = s.second ? b : a;
+
+			// Retire sides the sweep has passed
+			vOther.erase(std::remove_if(vOther.begin(), vOther.end(), [&](const uint32_t k)
+				{ return other[k].max(other[(k + 1) % other.size()]).x < vMin.x; }), vOther.end());
+
+			for (const uint32_t k : vOther)
+			{
+				const auto oMin = other[k].min(other[(k + 1) % other.size()]);
+				const auto oMax = other[k].max(other[(k + 1) % other.size()]);
+				if (oMax.y < vMin.y || oMin.y > vMax.y) continue;
+				if (s.second) internal::boolean_cross(a, s.first, b, k, scratch);
+				else internal::boolean_cross(a, k, b, s.first, scratch);
+			}
+			vOwn.push_back(s.first);
+		}
+
+		internal::boolean_parts(a, scratch.splits_a, scratch.parts_a);
+		internal::boolean_parts(b, scratch.splits_b, scratch.parts_b);
+
+		// Sorted copies to find parts shared by both polygons
+		scratch.kept.assign(scratch.parts_b.begin(), scratch.parts_b.end());
+		std::sort(scratch.kept.begin(), scratch.kept.end(), internal::boolean_part_less);
+		auto& vSortedA = scratch.sorted_a;
+		vSortedA.assign(scratch.parts_a.begin(), scratch.parts_a.end());
+		std::sort(vSortedA.begin(), vSortedA.end(), internal::boolean_part_less);
+
+		auto& ia = scratch.index_a;
+		auto& ib = scratch.index_b;
+		ia.pos.assign(a.begin(), a.end());
+		ia.rebuild();
+		ib.pos.assign(b.begin(), b.end());
+		ib.rebuild();
+
+		auto& vResult = scratch.result;
+		vResult.clear();
+
+		// Parts of a: shared parts going the same way as b's are kept by union and
+		// intersection, going the opposite way by difference
+		for (const auto& p : scratch.parts_a)
+		{
+			const bool bSame = internal::boolean_has_part(scratch.kept, p.start, p.end);
+			const bool bOpposite = !bSame && internal::boolean_has_part(scratch.kept, p.end, p.start);
+			bool bKeep;
+			if (bSame) bKeep = op != boolean_op::subtract;
+			else if (bOpposite) bKeep = op == boolean_op::subtract;
+			else bKeep = internal::boolean_inside(p, ib) == (op == boolean_op::intersect);
+			if (bKeep) vResult.push_back(p);
+		}
+
+		// Parts of b, with shared parts already dealt with
+		for (const auto& p : scratch.parts_b)
+		{
+			if (internal::boolean_has_part(vSortedA, p.start, p.end) || internal::boolean_has_part(vSortedA, p.end, p.start))
+				continue;
+			const bool bInside = internal::boolean_inside(p, ia);
+			if (op == boolean_op::unite && !bInside) vResult.push_back(p);
+			if (op == boolean_op::intersect && bInside) vResult.push_back(p);
+			if (op == boolean_op::subtract && bInside) vResult.push_back({ p.end, p.start });
+		}
+
+		// Chain parts into rings, looking up parts by their start point
+		std::sort(vResult.begin(), vResult.end(), internal::boolean_part_less);
+		size_t nRings = 0;
+		for (size_t i = 0; i < vResult.size(); i++)
+		{
+			if (vResult[i].bUsed) continue;
+			if (nRings == out.size()) out.emplace_back();
+			auto& ring = out[nRings++].pos;
+			ring.clear();
+
+			// A chain that can't be followed back to its start, which only precision
+			// problems could cause, is dropped rather than closed up into a wrong ring
+			size_t k = i;
+			bool bClosed = false;
+			while (true)
+			{
+				vResult[k].bUsed = true;
+				ring.push_back(olc::v_2d<T1>(vResult[k].start));
+				if (vResult[k].end == vResult[i].start) { bClosed = true; break; }
+
+				// Next unused part starting where this one ends
+				const internal::boolean_part key{ vResult[k].end, { -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() } };
+				auto it = std::lower_bound(vResult.begin(), vResult.end(), key, internal::boolean_part_less);
+				while (it != vResult.end() && it->start == key.start && it->bUsed) ++it;
+				if (it == vResult.end() || it->start != key.start) break;
+				k = size_t(it - vResult.begin());
+			}
+
+			if (!bClosed || ring.size() < 3) nRings--;
+		}
+		out.resize(nRings);
+	}
+
+	// combine(poly,poly,op)
+	// Returns union, intersection or difference (a - b) of two simple polygons as rings
+	template<typename T1, typename T2>
+	inline std::vector<polygon<T1>> combine(const polygon<T1>& a, const polygon<T2>& b, const boolean_op op)
+	{
+		clip_scratch scratch;
+		std::vector<polygon<T1>> out;
+		combine(a, b, op, out, scratch);
+		return out;
+	}
+
+	// SIMPLIFICATION =======================================================================================================
+
+	// Reduces the number of vertices of a polyline (a vector of points) or polygon while
+	// keeping its shape:
+	//
+	// simplify_dp() - Douglas-Peucker, keeps vertices so that no removed vertex is further
+	//                 than epsilon from the simplified outline
+	// simplify_vw() - Visvalingam-Whyatt, repeatedly removes the vertex forming the smallest
+	//                 triangle with its neighbours, until all remaining triangles have at
+	//                 least the given area
+	//
+	// Polylines keep their end points, polygons keep at least 3 vertices. simplify_stream
+	// applies Douglas-Peucker to points supplied one at a time, emitting vertices as they
+	// are decided and only holding a bounded window of recent points.
+
+	namespace internal
+	{
+		// Squared distance from p to the segment a-b
+		inline double segment_distance2(const olc::v_2d<double>& a, const olc::v_2d<double>& b, const olc::v_2d<double>& p)
+		{
+			const auto d = b - a;
+			const double l2 = d.mag2();
+			double t = l2 > 0.0 ? (p - a).dot(d) / l2 : 0.0;
+			t = std::clamp(t, 0.0, 1.0);
+			return (p - (a + d * t)).mag2();
+		}
+
+		// Marks vertices kept by Douglas-Peucker between first and last, with indices
+		// wrapping around n so a closed outline can be passed in two halves
+		template<typename T>
+		inline void douglas_peucker_mark(const olc::v_2d<T>* p, const size_t n, const size_t first, const size_t last,
+			const double epsilon2, std::vector<uint8_t>& keep, std::vector<std::pair<size_t, size_t>>& stack)
+		{
+			stack.clear();
+			stack.push_back({ first, last });
+			while (!stack.empty())
+			{
+				const auto [i0, i1] = stack.back();
+				stack.pop_back();
+
+				const olc::v_2d<double> a = p[i0 % n], b = p[i1 % n];
+				double dFurthest = -1.0;
+				size_t nFurthest = i0;
+				for (size_t i = i0 + 1; i < i1; i++)
+				{
+					const double d = segment_distance2(a, b, p[i % n]);
+					if (d > dFurthest) { dFurthest = d; nFurthest = i; }
+				}
+
+				if (dFurthest > epsilon2)
+				{
+					keep[nFurthest % n] = 1;
+					stack.push_back({ nFurthest, i1 });
+					stack.push_back({ i0, nFurthest });
+				}
+			}
+		}
+
+		template<typename T>
+		inline double visvalingam_area(const std::vector<olc::v_2d<T>>& p, const size_t a, const size_t b, const size_t c)
+		{
+			const olc::v_2d<double> va = p[a], vb = p[b], vc = p[c];
+			return std::abs((vb - va).cross(vc - va)) * 0.5;
+		}
+
+		// Removes vertices by Visvalingam-Whyatt, leaving kept vertices in out
+		template<typename T>
+		inline void visvalingam(const std::vector<olc::v_2d<T>>& p, const double min_area, const bool bClosed, std::vector<olc::v_2d<T>>& out)
+		{
+			const size_t n = p.size();
+			const size_t nMinimum = bClosed ? 3 : 2;
+			if (n <= nMinimum) { out.assign(p.begin(), p.end()); return; }
+
+			// Vertices form a linked list, with a heap of candidates. Heap entries go stale
+			// when a neighbour is removed, and are recognised by their area no longer matching.
+			std::vector<size_t> prev(n), next(n);
+			std::vector<double> area(n, std::numeric_limits<double>::infinity());
+			for (size_t i = 0; i < n; i++)
+			{
+				prev[i] = (i + n - 1) % n;
+				next[i] = (i + 1) % n;
+			}
+
+			using entry = std::pair<double, size_t>;
+			std::vector<entry> heap;
+			heap.reserve(n);
+			for (size_t i = bClosed ? 0 : 1; i < (bClosed ? n : n - 1); i++)
+			{
+				area[i] = visvalingam_area(p, prev[i], i, next[i]);
+				heap.push_back({ area[i], i });
+			}
+			const auto greater = [](const entry& x, const entry& y) { return x > y; };
+			std::make_heap(heap.begin(), heap.end(), greater);
+
+			std::vector<uint8_t> removed(n, 0);
+			size_t nRemaining = n;
+			double dLargest = 0.0;
+			while (!heap.empty() && nRemaining > nMinimum)
+			{
+				std::pop_heap(heap.begin(), heap.end(), greater);
+				const auto [dArea, i] = heap.back();
+				heap.pop_back();
+				if (removed[i] || dArea != area[i]) continue;
+				if (dArea >= min_area) break;
+
+				// A neighbour's area never drops below that of a vertex already removed,
+				// so removal order follows the areas seen
+				dLargest = std::max(dLargest, dArea);
+				removed[i] = 1;
+				nRemaining--;
+				next[prev[i]] = next[i];
+				prev[next[i]] = prev[i];
+
+				for (const size_t k : { prev[i], next[i] })
+				{
+					if (!bClosed && (k == 0 || k == n - 1)) continue;
+					area[k] = std::max(dLargest, visvalingam_area(p, prev[k], k, next[k]));
+					heap.push_back({ area[k], k });
+					std::push_heap(heap.begin(), heap.end(), greater);
+				}
+			}
+
+			out.clear();
+			for (size_t i = 0; i < n; i++)
+				if (!removed[i]) out.push_back(p[i]);
+		}
+	}
+
+	// simplify_dp(points,epsilon,out)
+	// Simplifies polyline with Douglas-Peucker, writing kept vertices to out
+	template<typename T1, typename T2>
+	inline void simplify_dp(const std::vector<olc::v_2d<T1>>& points, const T2 epsilon, std::vector<olc::v_2d<T1>>& out)
+	{
+		const size_t n = points.size();
+		if (n <= 2) { out.assign(points.begin(), points.end()); return; }
+
+		std::vector<uint8_t> keep(n, 0);
+		std::vector<std::pair<size_t, size_t>> stack;
+		keep[0] = keep[n - 1] = 1;
+		internal::douglas_peucker_mark(points.data(), n, 0, n - 1, double(epsilon) * double(epsilon), keep, stack);
+
+		out.clear();
+		for (size_t i = 0; i < n; i++)
+			if (keep[i]) out.push_back(points[i]);
+	}
+
+	// simplify_dp(points,epsilon)
+	// Returns polyline simplified with Douglas-Peucker
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T1>> simplify_dp(const std::vector<olc::v_2d<T1>>& points, const T2 epsilon)
+	{
+		std::vector<olc::v_2d<T1>> out;
+		simplify_dp(points, epsilon, out);
+		return out;
+	}
+
+	// simplify_dp(poly,epsilon)
+	// Returns polygon simplified with Douglas-Peucker
+	template<typename T1, typename T2>
+	inline polygon<T1> simplify_dp(const polygon<T1>& poly, const T2 epsilon)
+	{
+		const size_t n = poly.pos.size();
+		if (n <= 3) return poly;
+
+		// Split the outline at the first vertex and the vertex furthest from it, both of
+		// which are kept, then simplify each half
+		size_t nFurthest = 0;
+		double dFurthest = -1.0;
+		for (size_t i = 1; i < n; i++)
+		{
+			const double d = (olc::v_2d<double>(poly.pos[i]) - olc::v_2d<double>(poly.pos[0])).mag2();
+			if (d > dFurthest) { dFurthest = d; nFurthest = i; }
+		}
+
+		std::vector<uint8_t> keep(n, 0);
+		std::vector<std::pair<size_t, size_t>> stack;
+		keep[0] = keep[nFurthest] = 1;
+		const double epsilon2 = double(epsilon) * double(epsilon);
+		internal::douglas_peucker_mark(poly.pos.data(), n, 0, nFurthest, epsilon2, keep, stack);
+		internal::douglas_peucker_mark(poly.pos.data(), n, nFurthest, n, epsilon2, keep, stack);
+
+		polygon<T1> out;
+		for (size_t i = 0; i < n; i++)
+			if (keep[i]) out.pos.push_back(poly.pos[i]);
+
+		// Two points make no polygon, so restore the vertex furthest from their line
+		if (out.pos.size() < 3)
+		{
+			size_t nWidest = 0;
+			double dWidest = -1.0;
+			for (size_t i = 0; i < n; i++)
+			{
+				const double d = internal::segment_distance2(poly.pos[0], poly.pos[nFurthest], poly.pos[i]);
+				if (d > dWidest) { dWidest = d; nWidest = i; }
+			}
+			keep[nWidest] = 1;
+			out.pos.clear();
+			for (size_t i = 0; i < n; i++)
+				if (keep[i]) out.pos.push_back(poly.pos[i]);
+		}
+		return out;
+	}
+
+	// simplify_vw(points,area,out)
+	// Simplifies polyline with Visvalingam-Whyatt, writing kept vertices to out
+	template<typename T1, typename T2>
+	inline void simplify_vw(const std::vector<olc::v_2d<T1>>& points, const T2 min_area, std::vector<olc::v_2d<T1>>& out)
+	{
+		internal::visvalingam(points, double(min_area), false, out);
+	}
+
+	// simplify_vw(points,area)
+	// Returns polyline simplified with Visvalingam-Whyatt
+	template<typename T1, typename T2>
+	inline std::vector<olc::v_2d<T1>> simplify_vw(const std::vector<olc::v_2d<T1>>& points, const T2 min_area)
+	{
+		std::vector<olc::v_2d<T1>> out;
+		internal::visvalingam(points, double(min_area), false, out);
+		return out;
+	}
+
+	// simplify_vw(poly,area)
+	// Returns polygon simplified with Visvalingam-Whyatt
+	template<typename T1, typename T2>
+	inline polygon<T1> simplify_vw(const polygon<T1>& poly, const T2 min_area)
+	{
+		polygon<T1> out;
+		internal::visvalingam(poly.pos, double(min_area), true, out.pos);
+		return out;
+	}
+
+	// Douglas-Peucker simplification of a polyline supplied a point at a time. Points are
+	// held until the window fills, then the window is simplified and every vertex that
+	// later points cannot change is passed to the emit callback. Vertices where windows
+	// meet are always kept, so the result can have a few more vertices than simplifying
+	// the whole polyline at once, but never strays further than epsilon from it.
+	template<typename T>
+	struct simplify_stream
+	{
+		double epsilon2 = 0.0;
+		size_t window = 0;
+		std::vector<olc::v_2d<T>> points;
+
+		inline simplify_stream(const double epsilon, const size_t window_size = 256)
+			: epsilon2(epsilon * epsilon), window(std::max<size_t>(window_size, 3))
+		{
+			points.reserve(window);
+		}
+
+		// Adds a point, calling emit(vertex) for any vertices now decided
+		template<typename F>
+		inline void push(const olc::v_2d<T>& p, F&& emit)
+		{
+			if (points.empty()) emit(p);
+			points.push_back(p);
+			if (points.size() < window) return;
+
+			mark();
+
+			// Restart the window from its last kept vertex rather than its final point,
+			// which was only kept for ending the window. If there is no such vertex, the
+			// final point is committed to instead.
+			size_t nRestart = points.size() - 1;
+			for (size_t i = points.size() - 2; i > 0; i--)
+				if (keep[i]) { nRestart = i; break; }
+
+			for (size_t i = 1; i <= nRestart; i++)
+				if (keep[i] || i == nRestart) emit(points[i]);
+			points.erase(points.begin(), points.begin() + nRestart);
+		}
+
+		// Emits the remaining vertices, ending with the final point, and resets the stream
+		template<typename F>
+		inline void flush(F&& emit)
+		{
+			if (points.size() > 1)
+			{
+				mark();
+				for (size_t i = 1; i < points.size(); i++)
+					if (keep[i]) emit(points[i]);
+			}
+			points.clear();
+		}
+
+	private:
+		std::vector<uint8_t> keep;
+		std::vector<std::pair<size_t, size_t>> stack;
+
+		inline void mark()
+		{
+			keep.assign(points.size(), 0);
+			keep.front() = keep.back() = 1;
+			internal::douglas_peucker_mark(points.data(), points.size(), 0, points.size() - 1, epsilon2, keep, stack);
+		}
+	};
+
+	// GJK ==================================================================================================================
+
+	// gjk(a,b) finds how far apart any two convex shapes are, using only each shape's support
+	// function - the point of the shape furthest along a given direction. Points, lines,
+	// rects, circles, triangles and convex polygons are supported, so any pair of them
+	// works without a dedicated overload. Circles are handled as their middle point, with
+	// the radii taken off the result.
+	//
+	// Passing the same gjk_simplex between calls for a pair of shapes warm-starts the
+	// search from where the last one finished, which for shapes that have only moved a
+	// little usually means one or two iterations.
+
+	// The directions that found the final simplex of a GJK query. Being directions, not
+	// points, they remain a good first guess after the shapes have moved.
+	struct gjk_simplex
+	{
+		size_t count = 0;
+		std::array<olc::v_2d<double>, 3> direction;
+	};
+
+	struct gjk_result
+	{
+		// Shapes overlap, including touching
+		bool overlap = false;
+		// Distance between shapes, zero if they overlap
+		double distance = 0.0;
+		// Closest points on each shape, when they don't overlap
+		olc::v_2d<double> on_a;
+		olc::v_2d<double> on_b;
+	};
+
+	namespace internal
+	{
+		template<typename T>
+		inline olc::v_2d<double> support(const olc::v_2d<T>& p, const olc::v_2d<double>&)
+		{
+			return p;
+		}
+
+		template<typename T>
+		inline olc::v_2d<double> support(const line<T>& l, const olc::v_2d<double>& d)
+		{
+			return d.dot(olc::v_2d<double>(l.end - l.start)) > 0.0 ? l.end : l.start;
+		}
+
+		template<typename T>
+		inline olc::v_2d<double> support(const rect<T>& r, const olc::v_2d<double>& d)
+		{
+			const olc::v_2d<double> a = r.pos, b = r.pos + r.size;
+			return { d.x > 0.0 ? std::max(a.x, b.x) : std::min(a.x, b.x), d.y > 0.0 ? std::max(a.y, b.y) : std::min(a.y, b.y) };
+		}
+
+		template<typename T>
+		inline olc::v_2d<double> support(const circle<T>& c, const olc::v_2d<double>&)
+		{
+			return c.pos;
+		}
+
+		template<typename T>
+		inline olc::v_2d<double> support_vertices(const olc::v_2d<T>* p, const size_t n, const olc::v_2d<double>& d)
+		{
+			size_t nBest = 0;
+			double dBest = -std::numeric_limits<double>::infinity();
+			for (size_t i = 0; i < n; i++)
+			{
+				const double s = d.dot(olc::v_2d<double>(p[i]));
+				if (s > dBest) { dBest = s; nBest = i; }
+			}
+			return p[nBest];
+		}
+
+		template<typename T>
+		inline olc::v_2d<double> support(const triangle<T>& t, const olc::v_2d<double>& d)
+		{
+			return support_vertices(t.pos.data(), 3, d);
+		}
+
+		template<typename T>
+		inline olc::v_2d<double> support(const polygon<T>& p, const olc::v_2d<double>& d)
+		{
+			return support_vertices(p.pos.data(), p.pos.size(), d);
+		}
+
+		// Radius added around the support points. Every shape has an overload, rather than
+		// a catch-all, so that shapes derived from circle still find theirs.
+		template<typename T> inline double support_radius(const olc::v_2d<T>&) { return 0.0; }
+		template<typename T> inline double support_radius(const line<T>&) { return 0.0; }
+		template<typename T> inline double support_radius(const rect<T>&) { return 0.0; }
+		template<typename T> inline double support_radius(const triangle<T>&) { return 0.0; }
+		template<typename T> inline double support_radius(const polygon<T>&) { return 0.0; }
+
+		template<typename T>
+		inline double support_radius(const circle<T>& c)
+		{
+			return double(c.radius);
+		}
+
+		// A point of the Minkowski difference a - b, with where it came from
+		struct gjk_vertex
+		{
+			olc::v_2d<double> a;
+			olc::v_2d<double> b;
+			olc::v_2d<double> w;
+			olc::v_2d<double> direction;
+			double weight = 0.0;
+		};
+
+		template<typename S1, typename S2>
+		inline gjk_vertex gjk_support(const S1& a, const S2& b, const olc::v_2d<double>& offset, const olc::v_2d<double>& d)
+		{
+			gjk_vertex v;
+			v.a = support(a, d);
+			v.b = support(b, -d) + offset;
+			v.w = v.a - v.b;
+			v.direction = d;
+			return v;
+		}
+
+		// Reduces the simplex to the feature closest to the origin, setting barycentric
+		// weights. Returns false if a triangle simplex encloses the origin.
+		inline bool gjk_solve(std::array<gjk_vertex, 3>& s, size_t& n)
+		{
+			if (n == 1)
+			{
+				s[0].weight = 1.0;
+				return true;
+			}
+
+			if (n == 2)
+			{
+				const auto e = s[1].w - s[0].w;
+				const double d1 = s[1].w.dot(e);
+				const double d2 = -s[0].w.dot(e);
+				if (d2 <= 0.0) { s[0].weight = 1.0; n = 1; return true; }
+				if (d1 <= 0.0) { s[0] = s[1]; s[0].weight = 1.0; n = 1; return true; }
+				s[0].weight = d1 / (d1 + d2);
+				s[1].weight = d2 / (d1 + d2);
+				return true;
+			}
+
+			// Triangle, by the Voronoi regions of its vertices and edges
+			const auto& w1 = s[0].w; const auto& w2 = s[1].w; const auto& w3 = s[2].w;
+			const auto e12 = w2 - w1, e13 = w3 - w1, e23 = w3 - w2;
+			const double d12_1 = w2.dot(e12), d12_2 = -w1.dot(e12);
+			const double d13_1 = w3.dot(e13), d13_2 = -w1.dot(e13);
+			const double d23_1 = w3.dot(e23), d23_2 = -w2.dot(e23);
+			const double n123 = e12.cross(e13);
+			const double d123_1 = n123 * w2.cross(w3);
+			const double d123_2 = n123 * w3.cross(w1);
+			const double d123_3 = n123 * w1.cross(w2);
+
+			auto keep = [&](const size_t i, const size_t j, const double a, const double b)
+			{
+				const gjk_vertex vi = s[i], vj = s[j];
+				s[0] = vi; s[0].weight = a / (a + b);
+				s[1] = vj; s[1].weight = b / (a + b);
+				n = 2;
+			};
+
+			if (d12_2 <= 0.0 && d13_2 <= 0.0) { s[0].weight = 1.0; n = 1; return true; }
+			if (d12_1 > 0.0 && d12_2 > 0.0 && d123_3 <= 0.0) { keep(0, 1, d12_1, d12_2); return true; }
+			if (d13_1 > 0.0 && d13_2 > 0.0 && d123_2 <= 0.0) { keep(0, 2, d13_1, d13_2); return true; }
+			if (d12_1 <= 0.0 && d23_2 <= 0.0) { s[0] = s[1]; s[0].weight = 1.0; n = 1; return true; }
+			if (d13_1 <= 0.0 && d23_1 <= 0.0) { s[0] = s[2]; s[0].weight = 1.0; n = 1; return true; }
+			if (d23_1 > 0.0 && d23_2 > 0.0 && d123_1 <= 0.0) { keep(1, 2, d23_1, d23_2); return true; }
+			return false;
+		}
+	}
+
+	namespace internal
+	{
+		// GJK between a and b displaced by offset, which lets swept tests move a shape
+		// without copying it
+		template<typename S1, typename S2>
+		inline gjk_result gjk_offset(const S1& a, const S2& b, const olc::v_2d<double>& offset, gjk_simplex& cache)
+		{
+			std::array<gjk_vertex, 3> s;
+			size_t n = 0;
+
+			// Rebuild last simplex from its directions, ignoring any that now repeat a vertex
+			for (size_t i = 0; i < std::min<size_t>(cache.count, 3); i++)
+			{
+				const auto v = gjk_support(a, b, offset, cache.direction[i]);
+				bool bRepeat = false;
+				for (size_t j = 0; j < n; j++) bRepeat |= s[j].w == v.w;
+				if (!bRepeat) s[n++] = v;
+			}
+			if (n == 0) s[n++] = gjk_support(a, b, offset, { 1.0, 0.0 });
+
+			gjk_result result;
+			bool bEnclosed = false;
+			olc::v_2d<double> v;
+			for (size_t nIteration = 0; nIteration < 64; nIteration++)
+			{
+				if (!gjk_solve(s, n)) { bEnclosed = true; break; }
+
+				v = {};
+				for (size_t i = 0; i < n; i++) v += s[i].w * s[i].weight;
+				const double v2 = v.mag2();
+				if (v2 == 0.0) { bEnclosed = true; break; }
+
+				// Stop once the next support point gets no closer to the origin
+				const auto next = gjk_support(a, b, offset, -v);
+				if (v2 - v.dot(next.w) <= 1e-12 * v2) break;
+
+				bool bRepeat = false;
+				for (size_t i = 0; i < n; i++) bRepeat |= s[i].w == next.w;
+				if (bRepeat) break;
+				s[n++] = next;
+			}
+
+			cache.count = n;
+			for (size_t i = 0; i < n; i++) cache.direction[i] = s[i].direction;
+
+			if (bEnclosed)
+			{
+				result.overlap = true;
+				return result;
+			}
+
+			for (size_t i = 0; i < n; i++)
+			{
+				result.on_a += s[i].a * s[i].weight;
+				result.on_b += s[i].b * s[i].weight;
+			}
+
+			// Core shapes are apart, take off the radii
+			const double ra = support_radius(a);
+			const double rb = support_radius(b);
+			const double d = std::sqrt(v.mag2());
+			if (d <= ra + rb)
+			{
+				result.overlap = true;
+				return result;
+			}
+
+			const auto vDir = v / d;
+			result.on_a -= vDir * ra;
+			result.on_b += vDir * rb;
+			result.distance = d - ra - rb;
+			return result;
+		}
+	}
+
+	// gjk(a,b,simplex)
+	// Returns whether two convex shapes overlap, and if not how far apart they are and
+	// their closest points. The simplex is used as a starting point and updated.
+	template<typename S1, typename S2>
+	inline gjk_result gjk(const S1& a, const S2& b, gjk_simplex& cache)
+	{
+		return internal::gjk_offset(a, b, { 0.0, 0.0 }, cache);
+	}
+
+	// gjk(a,b)
+	// Returns whether two convex shapes overlap, and if not how far apart they are and
+	// their closest points
+	template<typename S1, typename S2>
+	inline gjk_result gjk(const S1& a, const S2& b)
+	{
+		gjk_simplex cache;
+		return gjk(a, b, cache);
+	}
+
+	// CONTACTS =============================================================================================================
+
+	// contact(a,b) goes beyond overlaps(a,b), describing how two convex shapes overlap so
+	// they can be pushed apart. Rects, triangles and convex polygons find the axis of least
+	// penetration with the separating axis test, then clip the most opposed side of one
+	// shape against the other to get up to two contact points. Circles are solved directly.
+	// The manifold is a fixed size and nothing is allocated.
+
+	struct contact_manifold
+	{
+		// Unit direction in which to move b to separate it from a
+		olc::v_2d<double> normal;
+		// Number of contact points in use
+		size_t count = 0;
+		// Contact points, halfway between the two surfaces
+		std::array<olc::v_2d<double>, 2> point;
+		// How far the shapes interpenetrate at each point, along the normal
+		std::array<double, 2> depth{};
+
+		// Greatest depth over the contact points
+		inline double penetration() const
+		{
+			return count == 2 ? std::max(depth[0], depth[1]) : (count == 1 ? depth[0] : 0.0);
+		}
+	};
+
+	namespace internal
+	{
+		template<typename T>
+		inline convex_edges<T> contact_edges(const rect<T>& r, std::array<olc::v_2d<T>, 4>& corners)
+		{
+			corners = rect_corners(r);
+			return convex_edges<T>(corners.data(), 4);
+		}
+
+		template<typename T>
+		inline convex_edges<T> contact_edges(const triangle<T>& t, std::array<olc::v_2d<T>, 4>&)
+		{
+			return convex_edges<T>(t.pos.data(), 3);
+		}
+
+		template<typename T>
+		inline convex_edges<T> contact_edges(const polygon<T>& p, std::array<olc::v_2d<T>, 4>&)
+		{
+			return convex_edges<T>(p.pos.data(), p.pos.size());
+		}
+
+		template<typename E>
+		inline olc::v_2d<double> contact_normal(const E& e, const size_t i)
+		{
+			return e.normal(i).norm();
+		}
+
+		// Greatest separation of b from the sides of a, and which side. Sides of zero length,
+		// from repeated vertices, have no normal and are skipped; if a has no other sides it
+		// separates nothing
+		template<typename E1, typename E2>
+		inline double contact_separation(const E1& a, const E2& b, size_t& nSide)
+		{
+			double dBest = -std::numeric_limits<double>::infinity();
+			bool bAnySide = false;
+			for (size_t i = 0; i < a.count(); i++)
+			{
+				if (a.normal(i).mag2() == 0) continue;
+				bAnySide = true;
+				const auto n = contact_normal(a, i);
+				const auto v = a.vertex(i);
+				double dDeepest = std::numeric_limits<double>::infinity();
+				for (size_t j = 0; j < b.count(); j++)
+					dDeepest = std::min(dDeepest, n.dot(b.vertex(j) - v));
+				if (dDeepest > dBest) { dBest = dDeepest; nSide = i; }
+			}
+			return bAnySide ? dBest : std::numeric_limits<double>::infinity();
+		}
+
+		// Keeps the part of segment v with n.p <= o
+		inline size_t contact_clip(std::array<olc::v_2d<double>, 2>& v, const olc::v_2d<double>& n, const double o)
+		{
+			const double d0 = n.dot(v[0]) - o;
+			const double d1 = n.dot(v[1]) - o;
+			if (d0 > 0.0 && d1 > 0.0) return 0;
+			if (d0 > 0.0) v[0] = v[0] + (v[1] - v[0]) * (d0 / (d0 - d1));
+			else if (d1 > 0.0) v[1] = v[1] + (v[0] - v[1]) * (d1 / (d1 - d0));
+			return 2;
+		}
+
+		template<typename E1, typename E2>
+		inline std::optional<contact_manifold> contact_outlines(const E1& a, const E2& b)
+		{
+			if (a.count() < 3 || b.count() < 3) return std::nullopt;
+
+			size_t nSideA = 0, nSideB = 0;
+			const double dSepA = contact_separation(a, b, nSideA);
+			if (dSepA > 0.0) return std::nullopt;
+			const double dSepB = contact_separation(b, a, nSideB);
+			if (dSepB > 0.0) return std::nullopt;
+
+			// Side of least penetration is the reference, the other shape's side facing it
+			// most directly is the incident side
+			const bool bFlip = dSepB > dSepA;
+			auto solve = [&](const auto& ref, const size_t nRef, const auto& inc) -> std::optional<contact_manifold>
+			{
+				const auto n = contact_normal(ref, nRef);
+				size_t nInc = 0;
+				double dFacing = std::numeric_limits<double>::infinity();
+				for (size_t j = 0; j < inc.count(); j++)
+				{
+					if (inc.normal(j).mag2() == 0) continue;
+					const double d = n.dot(contact_normal(inc, j));
+					if (d < dFacing) { dFacing = d; nInc = j; }
+				}
+
+				std::array<olc::v_2d<double>, 2> v = { inc.vertex(nInc), inc.vertex((nInc + 1) % inc.count()) };
+				const auto r1 = ref.vertex(nRef);
+				const auto r2 = ref.vertex((nRef + 1) % ref.count());
+				const auto t = (r2 - r1).norm();
+				if (contact_clip(v, -t, -t.dot(r1)) == 0 || contact_clip(v, t, t.dot(r2)) == 0)
+					return std::nullopt;
+
+				contact_manifold m;
+				m.normal = bFlip ? -n : n;
+				for (const auto& p : v)
+				{
+					const double s = n.dot(p - r1);
+					if (s > 0.0 || m.count == 2) continue;
+					m.point[m.count] = p - n * (s * 0.5);
+					m.depth[m.count] = -s;
+					m.count++;
+				}
+
+				// Clipped points coincide when a corner meets a side
+				if (m.count == 2 && m.point[0] == m.point[1]) m.count = 1;
+				if (m.count == 0) return std::nullopt;
+				return m;
+			};
+
+			return bFlip ? solve(b, nSideB, a) : solve(a, nSideA, b);
+		}
+
+		// Circle against convex outline, with normal from outline to circle
+		template<typename E, typename T>
+		inline std::optional<contact_manifold> contact_outline_circle(const E& a, const circle<T>& c)
+		{
+			if (a.count() < 3) return std::nullopt;
+
+			const olc::v_2d<double> p = c.pos;
+			const double r = double(c.radius);
+
+			size_t nSide = 0;
+			double dSep = -std::numeric_limits<double>::infinity();
+			for (size_t i = 0; i < a.count(); i++)
+			{
+				if (a.normal(i).mag2() == 0) continue;
+				const double s = contact_normal(a, i).dot(p - a.vertex(i));
+				if (s > r) return std::nullopt;
+				if (s > dSep) { dSep = s; nSide = i; }
+			}
+
+			contact_manifold m;
+			m.count = 1;
+			const auto v1 = a.vertex(nSide);
+			const auto v2 = a.vertex((nSide + 1) % a.count());
+			m.normal = contact_normal(a, nSide);
+
+			// Outside the side, middle may be nearest to a corner instead
+			if (dSep > 0.0)
+			{
+				const olc::v_2d<double>* pCorner = nullptr;
+				if ((p - v1).dot(v2 - v1) <= 0.0) pCorner = &v1;
+				else if ((p - v2).dot(v1 - v2) <= 0.0) pCorner = &v2;
+				if (pCorner)
+				{
+					const auto d = p - *pCorner;
+					if (d.mag2() > r * r) return std::nullopt;
+					dSep = d.mag();
+					if (dSep > 0.0) m.normal = d / dSep;
+				}
+			}
+
+			m.depth[0] = r - dSep;
+			m.point[0] = p - m.normal * (r - m.depth[0] * 0.5);
+			return m;
+		}
+
+		inline std::optional<contact_manifold> contact_flip(std::optional<contact_manifold> m)
+		{
+			if (m.has_value()) m->normal = -m->normal;
+			return m;
+		}
+	}
+
+	// contact(r,r)
+	// Returns contact manifold between two rectangles, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const rect<T1>& a, const rect<T2>& b)
+	{
+		std::array<olc::v_2d<T1>, 4> sa; std::array<olc::v_2d<T2>, 4> sb;
+		return internal::contact_outlines(internal::contact_edges(a, sa), internal::contact_edges(b, sb));
+	}
+
+	// contact(r,t)
+	// Returns contact manifold between rectangle and triangle, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const rect<T1>& a, const triangle<T2>& b)
+	{
+		std::array<olc::v_2d<T1>, 4> sa; std::array<olc::v_2d<T2>, 4> sb;
+		return internal::contact_outlines(internal::contact_edges(a, sa), internal::contact_edges(b, sb));
+	}
+
+	// contact(r,poly)
+	// Returns contact manifold between rectangle and convex polygon, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const rect<T1>& a, const polygon<T2>& b)
+	{
+		std::array<olc::v_2d<T1>, 4> sa; std::array<olc::v_2d<T2>, 4> sb;
+		return internal::contact_outlines(internal::contact_edges(a, sa), internal::contact_edges(b, sb));
+	}
+
+	// contact(t,r)
+	// Returns contact manifold between triangle and rectangle, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const triangle<T1>& a, const rect<T2>& b)
+	{
+		std::array<olc::v_2d<T1>, 4> sa; std::array<olc::v_2d<T2>, 4> sb;
+		return internal::contact_outlines(internal::contact_edges(a, sa), internal::contact_edges(b, sb));
+	}
+
+	// contact(t,t)
+	// Returns contact manifold between two triangles, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const triangle<T1>& a, const triangle<T2>& b)
+	{
+		std::array<olc::v_2d<T1>, 4> sa; std::array<olc::v_2d<T2>, 4> sb;
+		return internal::contact_outlines(internal::contact_edges(a, sa), internal::contact_edges(b, sb));
+	}
+
+	// contact(t,poly)
+	// Returns contact manifold between triangle and convex polygon, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const triangle<T1>& a, const polygon<T2>& b)
+	{
+		std::array<olc::v_2d<T1>, 4> sa; std::array<olc::v_2d<T2>, 4> sb;
+		return internal::contact_outlines(internal::contact_edges(a, sa), internal::contact_edges(b, sb));
+	}
+
+	// contact(poly,r)
+	// Returns contact manifold between convex polygon and rectangle, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const polygon<T1>& a, const rect<T2>& b)
+	{
+		std::array<olc::v_2d<T1>, 4> sa; std::array<olc::v_2d<T2>, 4> sb;
+		return internal::contact_outlines(internal::contact_edges(a, sa), internal::contact_edges(b, sb));
+	}
+
+	// contact(poly,t)
+	// Returns contact manifold between convex polygon and triangle, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const polygon<T1>& a, const triangle<T2>& b)
+	{
+		std::array<olc::v_2d<T1>, 4> sa; std::array<olc::v_2d<T2>, 4> sb;
+		return internal::contact_outlines(internal::contact_edges(a, sa), internal::contact_edges(b, sb));
+	}
+
+	// contact(poly,poly)
+	// Returns contact manifold between two convex polygons, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const polygon<T1>& a, const polygon<T2>& b)
+	{
+		std::array<olc::v_2d<T1>, 4> sa; std::array<olc::v_2d<T2>, 4> sb;
+		return internal::contact_outlines(internal::contact_edges(a, sa), internal::contact_edges(b, sb));
+	}
+
+	// contact(c,c)
+	// Returns contact manifold between two circles, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const circle<T1>& a, const circle<T2>& b)
+	{
+		const olc::v_2d<double> d = olc::v_2d<double>(b.pos) - olc::v_2d<double>(a.pos);
+		const double r = double(a.radius) + double(b.radius);
+		if (d.mag2() > r * r) return std::nullopt;
+
+		// Concentric circles could be pushed apart any way
+		const double dist = d.mag();
+		contact_manifold m;
+		m.count = 1;
+		m.normal = dist > 0.0 ? d / dist : olc::v_2d<double>(1.0, 0.0);
+		m.depth[0] = r - dist;
+		m.point[0] = olc::v_2d<double>(a.pos) + m.normal * (double(a.radius) - m.depth[0] * 0.5);
+		return m;
+	}
+
+	// contact(r,c)
+	// Returns contact manifold between rectangle and circle, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const rect<T1>& a, const circle<T2>& b)
+	{
+		std::array<olc::v_2d<T1>, 4> sa;
+		return internal::contact_outline_circle(internal::contact_edges(a, sa), b);
+	}
+
+	// contact(c,r)
+	// Returns contact manifold between circle and rectangle, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const circle<T1>& a, const rect<T2>& b)
+	{
+		return internal::contact_flip(contact(b, a));
+	}
+
+	// contact(t,c)
+	// Returns contact manifold between triangle and circle, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const triangle<T1>& a, const circle<T2>& b)
+	{
+		std::array<olc::v_2d<T1>, 4> sa;
+		return internal::contact_outline_circle(internal::contact_edges(a, sa), b);
+	}
+
+	// contact(c,t)
+	// Returns contact manifold between circle and triangle, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const circle<T1>& a, const triangle<T2>& b)
+	{
+		return internal::contact_flip(contact(b, a));
+	}
+
+	// contact(poly,c)
+	// Returns contact manifold between convex polygon and circle, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const polygon<T1>& a, const circle<T2>& b)
+	{
+		std::array<olc::v_2d<T1>, 4> sa;
+		return internal::contact_outline_circle(internal::contact_edges(a, sa), b);
+	}
+
+	// contact(c,poly)
+	// Returns contact manifold between circle and convex polygon, if they overlap
+	template<typename T1, typename T2>
+	inline std::optional<contact_manifold> contact(const circle<T1>& a, const polygon<T2>& b)
+	{
+		return internal::contact_flip(contact(b, a));
+	}
+
+	// MINKOWSKI SUMS =======================================================================================================
+
+	// The Minkowski sum of two shapes is every point of one added to every point of the
+	// other. Summing an obstacle with a moving shape reflected through its origin gives
+	// the obstacle in configuration space: the moving shape collides with the obstacle
+	// exactly when its origin is inside the result. Sweeping a shape against obstacles then
+	// becomes a ray query, and testing a placement a point query, against shapes built once.
+	//
+	// Inputs must be convex polygons, the results are convex polygons turning positively.
+	// Circles are replaced by regular polygons that enclose them, with a given number of
+	// sides, so the results never under-estimate.
+
+	namespace internal
+	{
+		// Copies convex polygon turning positively, starting from its lowest vertex
+		template<typename T>
+		inline void minkowski_input(const polygon<T>& p, std::vector<olc::v_2d<double>>& out)
+		{
+			out.assign(p.pos.begin(), p.pos.end());
+			double dArea = 0.0;
+			for (size_t i = 0; i < out.size(); i++)
+				dArea += out[i].cross(out[(i + 1) % out.size()]);
+			if (dArea < 0.0) std::reverse(out.begin(), out.end());
+
+			const auto it = std::min_element(out.begin(), out.end(), [](const auto& a, const auto& b)
+				{ return a.y < b.y || (a.y == b.y && a.x < b.x); });
+			std::rotate(out.begin(), it, out.end());
+		}
+
+		// Regular polygon with the given number of sides enclosing a circle
+		template<typename T>
+		inline polygon<double> enclosing_polygon(const circle<T>& c, const size_t sides)
+		{
+			const size_t n = std::max<size_t>(sides, 3);
+			const double r = double(c.radius) / std::cos(pi / double(n));
+			polygon<double> p;
+			p.pos.resize(n);
+			for (size_t i = 0; i < n; i++)
+			{
+				const double a = 2.0 * pi * double(i) / double(n);
+				p.pos[i] = olc::v_2d<double>(c.pos) + olc::v_2d<double>(std::cos(a), std::sin(a)) * r;
+			}
+			return p;
+		}
+	}
+
+	// minkowski_sum(poly,poly)
+	// Returns Minkowski sum of two convex polygons, in time linear in their vertices
+	template<typename T1, typename T2>
+	inline polygon<T1> minkowski_sum(const polygon<T1>& a, const polygon<T2>& b)
+	{
+		if (a.pos.empty() || b.pos.empty()) return {};
+
+		std::vector<olc::v_2d<double>> va, vb;
+		internal::minkowski_input(a, va);
+		internal::minkowski_input(b, vb);
+
+		// Both start at their lowest vertex, so merging their sides in order of angle
+		// walks around the sum
+		const size_t na = va.size(), nb = vb.size();
+		polygon<T1> out;
+		out.pos.reserve(na + nb);
+		size_t i = 0, j = 0;
+		while (i < na || j < nb)
+		{
+			out.pos.push_back(olc::v_2d<T1>(va[i % na] + vb[j % nb]));
+			const auto ea = va[(i + 1) % na] - va[i % na];
+			const auto eb = vb[(j + 1) % nb] - vb[j % nb];
+			const double c = ea.cross(eb);
+			if (j == nb || (i < na && c > 0.0)) i++;
+			else if (i == na || c < 0.0) j++;
+			else { i++; j++; }
+		}
+		return out;
+	}
+
+	// minkowski_sum(poly,c,sides)
+	// Returns Minkowski sum of convex polygon and circle, the circle enclosed by a polygon with that many sides
+	template<typename T1, typename T2>
+	inline polygon<T1> minkowski_sum(const polygon<T1>& a, const circle<T2>& c, const size_t sides = 16)
+	{
+		return minkowski_sum(a, internal::enclosing_polygon(c, sides));
+	}
+
+	// offset(poly,radius,sides)
+	// Returns convex polygon grown outwards by radius, rounding corners with a polygon of that many sides
+	template<typename T1, typename T2>
+	inline polygon<T1> offset(const polygon<T1>& a, const T2 radius, const size_t sides = 16)
+	{
+		return minkowski_sum(a, circle<double>({ 0.0, 0.0 }, double(radius)), sides);
+	}
+
+	// cspace_obstacle(poly,poly)
+	// Returns convex obstacle in the configuration space of a convex shape, whose position is its origin
+	template<typename T1, typename T2>
+	inline polygon<T1> cspace_obstacle(const polygon<T1>& obstacle, const polygon<T2>& shape)
+	{
+		polygon<T2> reflected = shape;
+		for (auto& p : reflected.pos) p = -p;
+		return minkowski_sum(obstacle, reflected);
+	}
+
+	// cspace_obstacle(poly,c,sides)
+	// Returns convex obstacle in the configuration space of a circle, whose position is its middle
+	template<typename T1, typename T2>
+	inline polygon<T1> cspace_obstacle(const polygon<T1>& obstacle, const circle<T2>& shape, const size_t sides = 16)
+	{
+		return offset(obstacle, shape.radius, sides);
+	}
+
+	// ROTATING CALIPERS ====================================================================================================
+
+	// Measurements of convex polygons (such as from convex_hull()) found by rotating a pair
+	// of parallel lines, or four lines at right angles, around the outline. Each caliper
+	// only ever moves forwards, so each function is linear in the number of vertices.
+	//
+	// bounding_rect_area() and bounding_rect_perimeter() return the oriented rectangle of
+	// least area or perimeter enclosing the polygon, as a polygon of 4 vertices. One of its
+	// sides always lies along a side of the polygon.
+
+	namespace internal
+	{
+		// Oriented rectangle enclosing convex polygon that minimises area, or perimeter
+		template<typename T>
+		inline polygon<T> calipers_rect(const polygon<T>& poly, const bool bArea)
+		{
+			std::vector<olc::v_2d<double>> p;
+			minkowski_input(poly, p);
+			const size_t n = p.size();
+			if (n == 0) return {};
+			if (n == 1) return { { poly.pos[0], poly.pos[0], poly.pos[0], poly.pos[0] } };
+
+			// Calipers at furthest along the side, furthest from it, and furthest back along it
+			size_t j = 1, k = 1, l = 1;
+			double dBest = std::numeric_limits<double>::infinity();
+			std::array<olc::v_2d<double>, 4> vBest;
+			for (size_t i = 0; i < n; i++)
+			{
+				const auto& o = p[i];
+				const auto e = p[(i + 1) % n] - o;
+				if (e.mag2() == 0.0) continue;
+				const auto u = e.norm();
+				const auto v = u.perp();
+
+				for (size_t s = 0; s < n && u.dot(p[(j + 1) % n] - o) > u.dot(p[j] - o); s++) j = (j + 1) % n;
+				if (i == 0) k = j;
+				for (size_t s = 0; s < n && v.dot(p[(k + 1) % n] - o) > v.dot(p[k] - o); s++) k = (k + 1) % n;
+				if (i == 0) l = k;
+				for (size_t s = 0; s < n && u.dot(p[(l + 1) % n] - o) < u.dot(p[l] - o); s++) l = (l + 1) % n;
+
+				const double a = u.dot(p[l] - o);
+				const double b = u.dot(p[j] - o);
+				const double h = v.dot(p[k] - o);
+				const double d = bArea ? (b - a) * h : (b - a) + h;
+				if (d < dBest)
+				{
+					dBest = d;
+					vBest = { o + u * a, o + u * b, o + u * b + v * h, o + u * a + v * h };
+				}
+			}
+
+			polygon<T> out;
+			for (const auto& c : vBest) out.pos.push_back(olc::v_2d<T>(c));
+			return out;
+		}
+
+		// Calls f(a, b, c) for every side a-b of convex polygon and the vertex c furthest from it
+		template<typename F>
+		inline void calipers_antipodal(const std::vector<olc::v_2d<double>>& p, F&& f)
+		{
+			const size_t n = p.size();
+			size_t j = 1;
+			for (size_t i = 0; i < n; i++)
+			{
+				const auto& a = p[i];
+				const auto& b = p[(i + 1) % n];
+				for (size_t s = 0; s < n && (b - a).cross(p[(j + 1) % n] - a) > (b - a).cross(p[j] - a); s++)
+					j = (j + 1) % n;
+				f(a, b, p[j]);
+			}
+		}
+	}
+
+	// bounding_rect_area(poly)
+	// Returns oriented rectangle of least area enclosing convex polygon
+	template<typename T>
+	inline polygon<T> bounding_rect_area(const polygon<T>& poly)
+	{
+		return internal::calipers_rect(poly, true);
+	}
+
+	// bounding_rect_perimeter(poly)
+	// Returns oriented rectangle of least perimeter enclosing convex polygon
+	template<typename T>
+	inline polygon<T> bounding_rect_perimeter(const polygon<T>& poly)
+	{
+		return internal::calipers_rect(poly, false);
+	}
+
+	// diameter(poly)
+	// Returns line between the two vertices of convex polygon furthest apart
+	template<typename T>
+	inline line<T> diameter(const polygon<T>& poly)
+	{
+		std::vector<olc::v_2d<double>> p;
+		internal::minkowski_input(poly, p);
+		if (p.size() < 2) return p.empty() ? line<T>() : line<T>(poly.pos[0], poly.pos[0]);
+
+		// The furthest pair is always a side's end and the vertex furthest from that side
+		double dBest = -1.0;
+		olc::v_2d<double> vStart, vEnd;
+		internal::calipers_antipodal(p, [&](const auto& a, const auto& b, const auto& c)
+		{
+			for (const auto* v : { &a, &b })
+			{
+				const double d = (c - *v).mag2();
+				if (d > dBest) { dBest = d; vStart = *v; vEnd = c; }
+			}
+		});
+		return line<T>(olc::v_2d<T>(vStart), olc::v_2d<T>(vEnd));
+	}
+
+	// width(poly)
+	// Returns least distance between two parallel lines enclosing convex polygon
+	template<typename T>
+	inline double width(const polygon<T>& poly)
+	{
+		std::vector<olc::v_2d<double>> p;
+		internal::minkowski_input(poly, p);
+		if (p.size() < 3) return 0.0;
+
+		// One of the lines always lies along a side
+		double dBest = std::numeric_limits<double>::infinity();
+		internal::calipers_antipodal(p, [&](const auto& a, const auto& b, const auto& c)
+		{
+			const double l = (b - a).mag();
+			if (l > 0.0) dBest = std::min(dBest, (b - a).cross(c - a) / l);
+		});
+		return dBest;
+	}
+
+	// SCENES & RAY TRACING =================================================================================================
+
+	// A scene is a collection of lines, rects, circles, triangles and polygons, indexed by a
+	// bounding volume hierarchy (a tree of nested boxes) so queries against the whole scene
+	// only visit shapes near the query. Fill in the shape vectors, then call build(), and
+	// again whenever the shapes change.
+	//
+	// trace() follows a batch of rays through a scene, reflecting them off whatever they hit
+	// as reflect() would, and records the path of each as a polyline. Large batches are
+	// split across threads.
+
+	enum class scene_kind : uint8_t
+	{
+		line,
+		rect,
+		circle,
+		triangle,
+		polygon
+	};
+
+	// Identifies a shape in a scene by its kind and index in that kind's vector
+	struct scene_item
+	{
+		scene_kind kind = scene_kind::line;
+		uint32_t index = 0;
+	};
+
+	template<typename T>
+	struct scene
+	{
+		std::vector<line<T>> lines;
+		std::vector<rect<T>> rects;
+		std::vector<circle<T>> circles;
+		std::vector<triangle<T>> triangles;
+		std::vector<polygon<T>> polygons;
+
+		// Box of a node encloses all shapes beneath it. Leaves have a count of items, other
+		// nodes are followed by their first child, with "second" locating the other.
+		struct node
+		{
+			olc::v_2d<double> box_min;
+			olc::v_2d<double> box_max;
+			uint32_t first = 0;
+			uint32_t count = 0;
+			uint32_t second = 0;
+		};
+
+		std::vector<node> nodes;
+		std::vector<scene_item> items;
+		std::vector<olc::v_2d<double>> item_min;
+		std::vector<olc::v_2d<double>> item_max;
+
+		// Builds the hierarchy over the current shapes
+		inline void build()
+		{
+			items.clear();
+			item_min.clear();
+			item_max.clear();
+			auto add = [&](const scene_kind kind, const auto& shapes)
+			{
+				for (size_t i = 0; i < shapes.size(); i++)
+				{
+					const auto r = envelope_r(shapes[i]);
+					const olc::v_2d<double> a = r.pos, b = r.pos + r.size;
+					items.push_back({ kind, uint32_t(i) });
+					item_min.push_back(a.min(b));
+					item_max.push_back(a.max(b));
+				}
+			};
+			add(scene_kind::line, lines);
+			add(scene_kind::rect, rects);
+			add(scene_kind::circle, circles);
+			add(scene_kind::triangle, triangles);
+			add(scene_kind::polygon, polygons);
+
+			nodes.clear();
+			if (items.empty()) return;
+			order.resize(items.size());
+			for (uint32_t i = 0; i < uint32_t(items.size()); i++) order[i] = i;
+			nodes.reserve(2 * items.size() / leaf_size + 1);
+			split(0, uint32_t(items.size()));
+
+			// Put items, and their boxes, in leaf order
+			std::vector<scene_item> vItems(items.size());
+			std::vector<olc::v_2d<double>> vMin(items.size()), vMax(items.size());
+			for (size_t i = 0; i < order.size(); i++)
+			{
+				vItems[i] = items[order[i]];
+				vMin[i] = item_min[order[i]];
+				vMax[i] = item_max[order[i]];
+			}
+			items.swap(vItems);
+			item_min.swap(vMin);
+			item_max.swap(vMax);
+		}
+
+	private:
+		static constexpr uint32_t leaf_size = 4;
+		std::vector<uint32_t> order;
+
+		// Splits items [first, first + count) at the middle along the longer side of their box
+		inline void split(const uint32_t first, const uint32_t count)
+		{
+			const uint32_t nNode = uint32_t(nodes.size());
+			nodes.emplace_back();
+			node n;
+			n.box_min = { std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+			n.box_max = -n.box_min;
+			for (uint32_t i = first; i < first + count; i++)
+			{
+				n.box_min = n.box_min.min(item_min[order[i]]);
+				n.box_max = n.box_max.max(item_max[order[i]]);
+			}
+
+			if (count <= leaf_size)
+			{
+				n.first = first;
+				n.count = count;
+				nodes[nNode] = n;
+				return;
+			}
+
+			const bool bAlongX = (n.box_max.x - n.box_min.x) >= (n.box_max.y - n.box_min.y);
+			auto centre = [&](const uint32_t i) { const auto c = item_min[i] + item_max[i]; return bAlongX ? c.x : c.y; };
+			const uint32_t nHalf = count / 2;
+			std::nth_element(order.begin() + first, order.begin() + first + nHalf, order.begin() + first + count,
+				[&](const uint32_t a, const uint32_t b) { return centre(a) < centre(b); });
+
+			split(first, nHalf);
+			n.second = uint32_t(nodes.size());
+			split(first + nHalf, count - nHalf);
+			nodes[nNode] = n;
+		}
+	};
+
+	namespace internal
+	{
+		// Ray against box, with precomputed 1/direction, true if it enters before t_max
+		inline bool scene_box_hit(const olc::v_2d<double>& o, const olc::v_2d<double>& inv_dir,
+			const olc::v_2d<double>& vMin, const olc::v_2d<double>& vMax, const double t_max)
+		{
+			double tNear = 0.0, tFar = t_max;
+			for (size_t a = 0; a < 2; a++)
+			{
+				const double lo = a == 0 ? vMin.x : vMin.y, hi = a == 0 ? vMax.x : vMax.y;
+				const double p = a == 0 ? o.x : o.y, inv = a == 0 ? inv_dir.x : inv_dir.y;
+				if (std::isinf(inv))
+				{
+					if (p < lo || p > hi) return false;
+					continue;
+				}
+				double t1 = (lo - p) * inv, t2 = (hi - p) * inv;
+				if (t1 > t2) std::swap(t1, t2);
+				tNear = std::max(tNear, t1);
+				tFar = std::min(tFar, t2);
+				if (tNear > tFar) return false;
+			}
+			return true;
+		}
+
+		// Ray against one shape of a scene
+		template<typename T1, typename T2>
+		inline std::optional<ray_hit<T2>> scene_raycast_item(const scene<T1>& s, const scene_item& item, const ray<T2>& q, const double t_max)
+		{
+			switch (item.kind)
+			{
+			case scene_kind::line: return raycast(q, s.lines[item.index], t_max);
+			case scene_kind::rect: return raycast(q, s.rects[item.index], t_max);
+			case scene_kind::circle: return raycast(q, s.circles[item.index], t_max);
+			case scene_kind::triangle: return raycast(q, s.triangles[item.index], t_max);
+			case scene_kind::polygon: return raycast(q, s.polygons[item.index], t_max);
+			}
+			return std::nullopt;
+		}
+
+		// Visits leaves whose boxes the ray enters before the current t_max, calling
+		// f(item_slot, t_max) for each item, which may lower t_max, or return true to stop.
+		// Boxes are grown by margin, for sweeping something with a size along the ray.
+		template<typename T1, typename T2, typename F>
+		inline void scene_walk(const scene<T1>& s, const ray<T2>& q, double& t_max, F&& f, const double margin = 0.0)
+		{
+			if (s.nodes.empty()) return;
+			const olc::v_2d<double> o = q.origin;
+			const olc::v_2d<double> inv_dir = { 1.0 / double(q.direction.x), 1.0 / double(q.direction.y) };
+			const olc::v_2d<double> vMargin = { margin, margin };
+
+			std::array<uint32_t, 64> stack;
+			size_t nStack = 0;
+			stack[nStack++] = 0;
+			while (nStack > 0)
+			{
+				const auto& n = s.nodes[stack[--nStack]];
+				if (!scene_box_hit(o, inv_dir, n.box_min - vMargin, n.box_max + vMargin, t_max)) continue;
+
+				if (n.count > 0)
+				{
+					for (uint32_t i = n.first; i < n.first + n.count; i++)
+					{
+						if (!scene_box_hit(o, inv_dir, s.item_min[i] - vMargin, s.item_max[i] + vMargin, t_max)) continue;
+						if (f(i, t_max)) return;
+					}
+				}
+				else
+				{
+					// Nearer child visited first, so its hits prune the other
+					uint32_t a = uint32_t(&n - s.nodes.data()) + 1, b = n.second;
+					const auto ca = s.nodes[a].box_min + s.nodes[a].box_max;
+					const auto cb = s.nodes[b].box_min + s.nodes[b].box_max;
+					if ((ca - cb).dot(olc::v_2d<double>(q.direction)) < 0.0) std::swap(a, b);
+					stack[nStack++] = a;
+					stack[nStack++] = b;
+				}
+			}
+		}
+
+		// Rays each thread must have before trace() splits its input across threads
+		inline constexpr size_t trace_rays_per_thread = 128;
+
+		template<typename T1, typename T2>
+		inline void trace_ray(const scene<T1>& s, ray<T2> q, const size_t bounces, const double max_length, std::vector<olc::v_2d<T2>>& path)
+		{
+			path.clear();
+			path.push_back(q.origin);
+			for (size_t nBounce = 0; nBounce < bounces; nBounce++)
+			{
+				double t_max = max_length;
+				std::optional<ray_hit<T2>> hit;
+				scene_walk(s, q, t_max, [&](const uint32_t i, double& t)
+					{
+						const auto h = scene_raycast_item(s, s.items[i], q, t);
+						if (h.has_value()) { hit = h; t = double(h->t); }
+						return false;
+					});
+
+				if (!hit.has_value())
+				{
+					if (max_length < std::numeric_limits<double>::infinity())
+						path.push_back(q.origin + q.direction * T2(max_length));
+					return;
+				}
+
+				// Leave from just off the surface, so the next leg can't hit it again at t = 0
+				const olc::v_2d<T2> vHit = q.origin + q.direction * hit->t;
+				path.push_back(vHit);
+				const double dScale = std::max({ 1.0, std::abs(double(vHit.x)), std::abs(double(vHit.y)) });
+				q = { vHit + hit->normal * T2(dScale * 1e-5), q.direction.reflect(hit->normal) };
+			}
+		}
+	}
+
+	// trace(s,vq,n,paths,length)
+	// Follows each ray through scene for up to n hits, reflecting at each, writing the points
+	// along its path (starting with its origin) into paths. Rays that hit nothing end max_length
+	// further on if that is finite.
+	template<typename T1, typename T2>
+	inline void trace(const scene<T1>& s, const std::vector<ray<T2>>& rays, const size_t bounces,
+		std::vector<std::vector<olc::v_2d<T2>>>& paths, const double max_length = std::numeric_limits<double>::infinity())
+	{
+		paths.resize(rays.size());
+
+		// Threads are only started when there is enough work to outweigh starting them
+		const size_t nThreads = std::min<size_t>(std::thread::hardware_concurrency(), rays.size() / internal::trace_rays_per_thread);
+		if (nThreads > 1)
+		{
+			// Interleaved, as rays in a batch tend to be ordered and neighbours cost the same
+			std::vector<std::thread> vWorkers;
+			for (size_t t = 0; t < nThreads; t++)
+			{
+				vWorkers.emplace_back([&, t]()
+					{
+						for (size_t i = t; i < rays.size(); i += nThreads)
+							internal::trace_ray(s, rays[i], bounces, max_length, paths[i]);
+					});
+			}
+			for (auto& w : vWorkers) w.join();
+		}
+		else
+		{
+			for (size_t i = 0; i < rays.size(); i++)
+				internal::trace_ray(s, rays[i], bounces, max_length, paths[i]);
+		}
+	}
+
+	// trace(s,vq,n,length)
+	// Returns the paths of rays followed through scene for up to n hits, reflecting at each
+	template<typename T1, typename T2>
+	inline std::vector<std::vector<olc::v_2d<T2>>> trace(const scene<T1>& s, const std::vector<ray<T2>>& rays, const size_t bounces,
+		const double max_length = std::numeric_limits<double>::infinity())
+	{
+		std::vector<std::vector<olc::v_2d<T2>>> paths;
+		trace(s, rays, bounces, paths, max_length);
+		return paths;
+	}
+
+	// VISIBILITY ===========================================================================================================
+
+	// visibility() finds the region that can be seen from a point, given line segments that
+	// block sight and a rectangle to bound the view, which must contain the point. Segment
+	// ends are swept around the viewpoint in order of angle, keeping the segments crossing
+	// the sweep in a tree ordered by distance, so the nearest - the one that is seen - is
+	// always to hand. The result is a polygon turning positively.
+	//
+	// Segments are first split wherever they cross each other. A visibility_cache keeps
+	// the split segments, and the order their ends were swept in last time. When only the
+	// viewpoint moves, that order is nearly right already and is quickly repaired.
+
+	struct visibility_cache
+	{
+		// Occluding segments, split where they crossed
+		std::vector<line<double>> segments;
+		// Segment ends in angular order around the last viewpoint, as segment * 2 + end
+		std::vector<uint32_t> order;
+		// Working storage for visibility(), kept so that repeated queries don't allocate
+		std::vector<line<double>> relative;
+		std::vector<double> angle;
+		std::vector<uint8_t> role;
+		std::vector<uint32_t> initial;
+		std::vector<uint32_t> status;
+
+		// Sets the occluding segments, and the view bounds whose sides are added to them
+		template<typename T1, typename T2>
+		inline void build(const std::vector<line<T1>>& lines, const rect<T2>& bounds)
+		{
+			source.clear();
+			for (const auto& l : lines) source.push_back({ l.start, l.end });
+			add_bounds(bounds);
+			split();
+		}
+
+		// Sets the occluding segments from the sides of all shapes in a scene, apart from
+		// circles, and the view bounds whose sides are added to them
+		template<typename T1, typename T2>
+		inline void build(const scene<T1>& s, const rect<T2>& bounds)
+		{
+			source.clear();
+			for (const auto& l : s.lines) source.push_back({ l.start, l.end });
+			for (const auto& r : s.rects)
+				for (size_t i = 0; i < r.side_count(); i++) source.push_back({ r.side(i).start, r.side(i).end });
+			for (const auto& t : s.triangles)
+				for (size_t i = 0; i < t.side_count(); i++) source.push_back({ t.side(i).start, t.side(i).end });
+			for (const auto& p : s.polygons)
+				for (size_t i = 0; i < p.pos.size(); i++) source.push_back({ p.side(i).start, p.side(i).end });
+			add_bounds(bounds);
+			split();
+		}
+
+	private:
+		std::vector<line<double>> source;
+
+		template<typename T>
+		inline void add_bounds(const rect<T>& bounds)
+		{
+			for (size_t i = 0; i < bounds.side_count(); i++)
+				source.push_back({ bounds.side(i).start, bounds.side(i).end });
+		}
+
+		static inline void cut(std::vector<std::pair<double, olc::v_2d<double>>>& cuts, const line<double>& l, const olc::v_2d<double>& p)
+		{
+			cuts.push_back({ (p - l.start).dot(l.end - l.start), p });
+		}
+
+		// Splits segments where they cross, found by a sweep along x
+		inline void split()
+		{
+			// Both segments are cut at the same point, so the pieces meet exactly
+			std::vector<std::vector<std::pair<double, olc::v_2d<double>>>> vCuts(source.size());
+			std::vector<uint32_t> vByX(source.size());
+			for (uint32_t i = 0; i < uint32_t(source.size()); i++) vByX[i] = i;
+			auto min_x = [&](const uint32_t i) { return std::min(source[i].start.x, source[i].end.x); };
+			auto max_x = [&](const uint32_t i) { return std::max(source[i].start.x, source[i].end.x); };
+			std::sort(vByX.begin(), vByX.end(), [&](const uint32_t a, const uint32_t b) { return min_x(a) < min_x(b); });
+
+			std::vector<uint32_t> vActive;
+			for (const uint32_t i : vByX)
+			{
+				vActive.erase(std::remove_if(vActive.begin(), vActive.end(), [&](const uint32_t k) { return max_x(k) < min_x(i); }), vActive.end());
+				const auto& a = source[i];
+				for (const uint32_t k : vActive)
+				{
+					const auto& b = source[k];
+					const auto d1 = a.end - a.start, d2 = b.end - b.start;
+					const double o1 = d1.cross(b.start - a.start), o2 = d1.cross(b.end - a.start);
+					const double o3 = d2.cross(a.start - b.start), o4 = d2.cross(a.end - b.start);
+					const bool bStraddleA = (o1 < 0.0 && o2 > 0.0) || (o1 > 0.0 && o2 < 0.0);
+					const bool bStraddleB = (o3 < 0.0 && o4 > 0.0) || (o3 > 0.0 && o4 < 0.0);
+
+					// Crossing, or one's end lying within the other, which is cut there too
+					if (bStraddleA && bStraddleB)
+					{
+						const auto p = a.start + d1 * (o3 / (o3 - o4));
+						cut(vCuts[i], a, p);
+						cut(vCuts[k], b, p);
+					}
+					else if (bStraddleB && (o1 == 0.0 || o2 == 0.0)) cut(vCuts[i], a, o1 == 0.0 ? b.start : b.end);
+					else if (bStraddleA && (o3 == 0.0 || o4 == 0.0)) cut(vCuts[k], b, o3 == 0.0 ? a.start : a.end);
+				}
+				vActive.push_back(i);
+			}
+
+			segments.clear();
+			for (size_t i = 0; i < source.size(); i++)
+			{
+				auto& c = vCuts[i];
+				std::sort(c.begin(), c.end(), [](const auto& x, const auto& y) { return x.first < y.first; });
+				olc::v_2d<double> vFrom = source[i].start;
+				for (const auto& [t, p] : c)
+				{
+					if (p != vFrom) segments.push_back({ vFrom, p });
+					vFrom = p;
+				}
+				if (source[i].end != vFrom) segments.push_back({ vFrom, source[i].end });
+			}
+
+			order.resize(segments.size() * 2);
+			for (uint32_t i = 0; i < uint32_t(order.size()); i++) order[i] = i;
+		}
+	};
+
+	namespace internal
+	{
+		// True if segment a (relative to the viewpoint) is nearer than b, where both cross
+		// the same ray from the viewpoint and don't cross each other
+		inline bool visibility_nearer(const line<double>& a, const uint32_t ia, const line<double>& b, const uint32_t ib)
+		{
+			if (ia == ib) return false;
+			const auto da = a.end - a.start;
+			const double so = da.cross(-a.start);
+			const double s1 = da.cross(b.start - a.start);
+			const double s2 = da.cross(b.end - a.start);
+
+			// Along the same line, so the same distance
+			if (s1 == 0.0 && s2 == 0.0) return ia < ib;
+
+			// b wholly beyond a, or wholly before it
+			if (s1 * so <= 0.0 && s2 * so <= 0.0) return true;
+			if (s1 * so >= 0.0 && s2 * so >= 0.0) return false;
+
+			// b straddles the line through a, so a is wholly to one side of b
+			const auto db = b.end - b.start;
+			const double to = db.cross(-b.start);
+			const double t1 = db.cross(a.start - b.start);
+			const double t2 = db.cross(a.end - b.start);
+			return t1 * to >= 0.0 && t2 * to >= 0.0;
+		}
+
+		// Where the ray from the viewpoint along d meets the line through segment s
+		inline olc::v_2d<double> visibility_hit(const olc::v_2d<double>& d, const line<double>& s)
+		{
+			const auto e = s.end - s.start;
+			return d * (s.start.cross(e) / d.cross(e));
+		}
+	}
+
+	// visibility(p,cache,poly)
+	// Computes region visible from point among cached segments, writing it to polygon
+	template<typename T1, typename T2>
+	inline void visibility(const olc::v_2d<T1>& viewpoint, visibility_cache& cache, polygon<T2>& out)
+	{
+		out.pos.clear();
+		const olc::v_2d<double> o = viewpoint;
+		const size_t n = cache.segments.size();
+
+		// Segments relative to the viewpoint, and the angles of their ends. A segment
+		// crossing the ray pointing along -x starts the sweep already in view, with
+		// its ends swapping roles.
+		auto& seg = cache.relative;
+		auto& angle = cache.angle;
+		auto& role = cache.role; // 0 none, 1 begin, 2 end
+		auto& vInitial = cache.initial;
+		seg.resize(n);
+		angle.assign(2 * n, 0.0);
+		role.assign(2 * n, 0);
+		vInitial.clear();
+		for (uint32_t i = 0; i < uint32_t(n); i++)
+		{
+			seg[i] = { cache.segments[i].start - o, cache.segments[i].end - o };
+			const auto& a = seg[i].start;
+			const auto& b = seg[i].end;
+
+			// Seen edge on, or touching the viewpoint, a segment hides nothing
+			if (a.cross(b) == 0.0) continue;
+
+			double aa = std::atan2(a.y, a.x), ab = std::atan2(b.y, b.x);
+			if (a.y == 0.0 && a.x < 0.0) aa = b.y > 0.0 ? pi : -pi;
+			if (b.y == 0.0 && b.x < 0.0) ab = a.y > 0.0 ? pi : -pi;
+			angle[2 * i] = aa;
+			angle[2 * i + 1] = ab;
+
+			const bool bCrosses = (a.y > 0.0 && b.y < 0.0) || (a.y < 0.0 && b.y > 0.0);
+			const bool bWraps = bCrosses && (a.x + (b.x - a.x) * (a.y / (a.y - b.y))) < 0.0;
+			const bool bStartFirst = (aa < ab) != bWraps;
+			role[2 * i] = bStartFirst ? 1 : 2;
+			role[2 * i + 1] = bStartFirst ? 2 : 1;
+			if (bWraps) vInitial.push_back(i);
+		}
+
+		// Repair the previous order by insertion sort, which costs little if it was close,
+		// giving up for a full sort if it wasn't
+		auto& order = cache.order;
+		auto less = [&](const uint32_t x, const uint32_t y) { return angle[x] < angle[y]; };
+		size_t nMoves = 0;
+		bool bSorted = true;
+		for (size_t i = 1; i < order.size() && bSorted; i++)
+		{
+			const uint32_t e = order[i];
+			size_t j = i;
+			for (; j > 0 && less(e, order[j - 1]); j--) order[j] = order[j - 1];
+			order[j] = e;
+			nMoves += i - j;
+			bSorted = nMoves <= 8 * order.size();
+		}
+		if (!bSorted) std::sort(order.begin(), order.end(), less);
+
+		// Segments crossing the sweep, nearest first. Few cross at once, so a sorted vector
+		// beats a tree here, and unlike one it keeps its storage between calls
+		auto nearer = [&](const uint32_t x, const uint32_t y) { return internal::visibility_nearer(seg[x], x, seg[y], y); };
+		auto& status = cache.status;
+		status.clear();
+		auto enter = [&](const uint32_t x) { status.insert(std::upper_bound(status.begin(), status.end(), x, nearer), x); };
+		auto leave = [&](const uint32_t x)
+		{
+			const auto it = std::find(status.begin(), status.end(), x);
+			if (it != status.end()) status.erase(it);
+		};
+		for (const uint32_t i : vInitial) enter(i);
+
+		auto emit = [&](const olc::v_2d<double>& p)
+		{
+			const olc::v_2d<T2> v = o + p;
+			if (out.pos.empty() || out.pos.back() != v) out.pos.push_back(v);
+		};
+
+		// Process ends sharing a direction together, noting if the nearest segment changed
+		size_t i = 0;
+		while (i < order.size())
+		{
+			if (role[order[i]] == 0) { i++; continue; }
+			const auto d = (order[i] & 1) ? seg[order[i] >> 1].end : seg[order[i] >> 1].start;
+			size_t j = i;
+			auto direction = [&](const uint32_t e) { return (e & 1) ? seg[e >> 1].end : seg[e >> 1].start; };
+			while (j < order.size() && (role[order[j]] == 0 || (direction(order[j]).cross(d) == 0.0 && direction(order[j]).dot(d) > 0.0))) j++;
+
+			const uint32_t nBefore = status.empty() ? uint32_t(n) : status.front();
+			for (size_t k = i; k < j; k++)
+				if (role[order[k]] == 2) leave(order[k] >> 1);
+			for (size_t k = i; k < j; k++)
+				if (role[order[k]] == 1) enter(order[k] >> 1);
+			const uint32_t nAfter = status.empty() ? uint32_t(n) : status.front();
+
+			if (nBefore != nAfter)
+			{
+				if (nBefore != n) emit(internal::visibility_hit(d, seg[nBefore]));
+				if (nAfter != n) emit(internal::visibility_hit(d, seg[nAfter]));
+			}
+			i = j;
+		}
+
+		while (out.pos.size() > 1 && out.pos.back() == out.pos.front()) out.pos.pop_back();
+	}
+
+	// visibility(p,vl,r)
+	// Returns region visible from point among line segments, bounded by rectangle
+	template<typename T1, typename T2, typename T3>
+	inline polygon<T1> visibility(const olc::v_2d<T1>& viewpoint, const std::vector<line<T2>>& segments, const rect<T3>& bounds)
+	{
+		visibility_cache cache;
+		cache.build(segments, bounds);
+		polygon<T1> out;
+		visibility(viewpoint, cache, out);
+		return out;
+	}
+
+	// TILE GRIDS ===========================================================================================================
+
+	// A tile_grid describes a regular grid of cells, such as a tile map, without storing what
+	// is in them - queries ask a callback about each cell instead. traverse() walks a ray
+	// through the cells it passes, in order, visiting each exactly once (Amanatides & Woo),
+	// so a ray crossing a huge map only costs as much as the cells it actually touches.
+
+	template<typename T>
+	struct tile_grid
+	{
+		// Top left of cell (0, 0)
+		olc::v_2d<T> origin;
+		// Size of each cell, positive
+		olc::v_2d<T> cell = { T(1), T(1) };
+		// Number of cells across and down
+		olc::vi2d size;
+
+		// Get the rectangle covered by a cell
+		inline rect<T> cell_rect(const olc::vi2d& c) const
+		{
+			return { origin + olc::v_2d<T>(T(c.x) * cell.x, T(c.y) * cell.y), cell };
+		}
+	};
+
+	// traverse(q,g,f,t)
+	// Calls visit(cell, t_enter, t_exit) for each grid cell the ray passes through, nearest
+	// first, up to t_max along the ray. Stops early if visit returns true, and returns whether it did.
+	template<typename T1, typename T2, typename F>
+	inline bool traverse(const ray<T1>& q, const tile_grid<T2>& g, F&& visit, const double t_max = std::numeric_limits<double>::infinity())
+	{
+		if (g.size.x <= 0 || g.size.y <= 0) return false;
+
+		const olc::v_2d<double> o = q.origin, d = q.direction;
+		const olc::v_2d<double> vMin = g.origin;
+		const olc::v_2d<double> vCell = g.cell;
+		const olc::v_2d<double> vMax = vMin + olc::v_2d<double>(vCell.x * g.size.x, vCell.y * g.size.y);
+
+		// Clip ray to the grid
+		double tEnter = 0.0, tExit = t_max;
+		for (size_t a = 0; a < 2; a++)
+		{
+			const double p = a == 0 ? o.x : o.y, v = a == 0 ? d.x : d.y;
+			const double lo = a == 0 ? vMin.x : vMin.y, hi = a == 0 ? vMax.x : vMax.y;
+			if (v == 0.0)
+			{
+				if (p < lo || p > hi) return false;
+				continue;
+			}
+			double t1 = (lo - p) / v, t2 = (hi - p) / v;
+			if (t1 > t2) std::swap(t1, t2);
+			tEnter = std::max(tEnter, t1);
+			tExit = std::min(tExit, t2);
+		}
+		if (tEnter > tExit) return false;
+
+		// Cell the ray starts in, and distances along it to the next column and row boundaries
+		const auto vStart = o + d * tEnter;
+		olc::vi2d c = {
+			std::clamp(int32_t(std::floor((vStart.x - vMin.x) / vCell.x)), 0, g.size.x - 1),
+			std::clamp(int32_t(std::floor((vStart.y - vMin.y) / vCell.y)), 0, g.size.y - 1) };
+		const olc::vi2d vStep = { d.x > 0.0 ? 1 : -1, d.y > 0.0 ? 1 : -1 };
+
+		auto boundary = [&](const int32_t n, const int32_t step, const double lo, const double size, const double p, const double v)
+		{
+			if (v == 0.0) return std::numeric_limits<double>::infinity();
+			return (lo + double(n + (step > 0 ? 1 : 0)) * size - p) / v;
+		};
+		double tNextX = boundary(c.x, vStep.x, vMin.x, vCell.x, o.x, d.x);
+		double tNextY = boundary(c.y, vStep.y, vMin.y, vCell.y, o.y, d.y);
+		const double tDeltaX = d.x != 0.0 ? vCell.x / std::abs(d.x) : std::numeric_limits<double>::infinity();
+		const double tDeltaY = d.y != 0.0 ? vCell.y / std::abs(d.y) : std::numeric_limits<double>::infinity();
+
+		double t = tEnter;
+		while (true)
+		{
+			const double tLeave = std::min({ tNextX, tNextY, tExit });
+			if (visit(c, t, tLeave)) return true;
+			if (tLeave >= tExit) return false;
+
+			t = tLeave;
+			if (tNextX < tNextY)
+			{
+				c.x += vStep.x;
+				tNextX += tDeltaX;
+			}
+			else
+			{
+				c.y += vStep.y;
+				tNextY += tDeltaY;
+			}
+			if (c.x < 0 || c.y < 0 || c.x >= g.size.x || c.y >= g.size.y) return false;
+		}
+	}
+
+	// collision(q,g,f)
+	// optionally returns collision point and collision normal of ray and the first grid cell
+	// for which solid(cell) is true, as collision(q,r) would for that cell's rectangle
+	template<typename T1, typename T2, typename F>
+	inline std::optional<std::pair<olc::v_2d<T1>, olc::v_2d<T1>>> collision(const ray<T1>& q, const tile_grid<T2>& g, F&& solid)
+	{
+		std::optional<std::pair<olc::v_2d<T1>, olc::v_2d<T1>>> hit;
+		traverse(q, g, [&](const olc::vi2d& c, double, double)
+			{
+				if (!solid(c)) return false;
+				hit = collision(q, g.cell_rect(c));
+				return hit.has_value();
+			});
+		return hit;
+	}
+
+	// OCCLUSION ============================================================================================================
+
+	// occluded() answers only whether anything blocks a ray before t_max, or a line segment
+	// between its ends, which is all shadow rays and line of sight checks need. Unlike
+	// raycast() it stops at the first hit of any shape rather than looking for the nearest,
+	// and never works out where or at what angle the hit was. Rays starting inside a shape
+	// are blocked if they leave it before t_max, as with raycast().
+
+	// occluded(q,t,l)
+	// Returns true if ray hits line segment no further than t_max along it
+	template<typename T1, typename T2>
+	inline bool occluded(const ray<T1>& q, const double t_max, const line<T2>& l)
+	{
+		return internal::raycast_segment(q, l.start, l.vector(), t_max).has_value();
+	}
+
+	// occluded(q,t,r)
+	// Returns true if ray hits rectangle no further than t_max along it
+	template<typename T1, typename T2>
+	inline bool occluded(const ray<T1>& q, const double t_max, const rect<T2>& r)
+	{
+		double tNear = -std::numeric_limits<double>::infinity();
+		double tFar = std::numeric_limits<double>::infinity();
+		for (size_t a = 0; a < 2; a++)
+		{
+			const double p = a == 0 ? double(q.origin.x) : double(q.origin.y);
+			const double v = a == 0 ? double(q.direction.x) : double(q.direction.y);
+			const double lo = a == 0 ? double(r.pos.x) : double(r.pos.y);
+			const double hi = lo + (a == 0 ? double(r.size.x) : double(r.size.y));
+			if (v == 0.0)
+			{
+				if (p < std::min(lo, hi) || p > std::max(lo, hi)) return false;
+				continue;
+			}
+			double t1 = (lo - p) / v, t2 = (hi - p) / v;
+			if (t1 > t2) std::swap(t1, t2);
+			tNear = std::max(tNear, t1);
+			tFar = std::min(tFar, t2);
+		}
+		if (tNear > tFar || tFar < 0.0) return false;
+		return (tNear >= 0.0 ? tNear : tFar) <= t_max;
+	}
+
+	// occluded(q,t,c)
+	// Returns true if ray hits circle no further than t_max along it
+	template<typename T1, typename T2>
+	inline bool occluded(const ray<T1>& q, const double t_max, const circle<T2>& c)
+	{
+		const double dx = double(q.origin.x) - c.pos.x;
+		const double dy = double(q.origin.y) - c.pos.y;
+		const double A = double(q.direction.x) * q.direction.x + double(q.direction.y) * q.direction.y;
+		const double B = dx * q.direction.x + dy * q.direction.y;
+		const double C = dx * dx + dy * dy - double(c.radius) * c.radius;
+		if (A == 0.0) return false;
+		const double D = B * B - A * C;
+		if (D < 0.0) return false;
+
+		// Compare roots (-B -/+ sqrt(D)) / A with t_max by squaring, so no square root
+		if (C > 0.0)
+		{
+			// Entry, when heading towards the circle
+			if (B > 0.0) return false;
+			const double m = -B - A * t_max;
+			return m <= 0.0 || m * m <= D;
+		}
+
+		// Exit, from inside
+		const double m = A * t_max + B;
+		return m >= 0.0 && D <= m * m;
+	}
+
+	// occluded(q,t,t)
+	// Returns true if ray hits triangle no further than t_max along it
+	template<typename T1, typename T2>
+	inline bool occluded(const ray<T1>& q, const double t_max, const triangle<T2>& t)
+	{
+		for (size_t i = 0; i < t.side_count(); i++)
+			if (internal::raycast_segment(q, t.pos[i], t.pos[(i + 1) % 3] - t.pos[i], t_max).has_value())
+				return true;
+		return false;
+	}
+
+	// occluded(q,t,poly)
+	// Returns true if ray hits polygon no further than t_max along it
+	template<typename T1, typename T2>
+	inline bool occluded(const ray<T1>& q, const double t_max, const polygon<T2>& p)
+	{
+		const size_t n = p.pos.size();
+		for (size_t i = 0; i < n; i++)
+			if (internal::raycast_segment(q, p.pos[i], p.pos[(i + 1) % n] - p.pos[i], t_max).has_value())
+				return true;
+		return false;
+	}
+
+	// occluded(q,t,vs)
+	// Returns true if ray hits any of the shapes no further than t_max along it
+	template<typename T1, typename S>
+	inline bool occluded(const ray<T1>& q, const double t_max, const std::vector<S>& shapes)
+	{
+		for (const auto& s : shapes)
+			if (occluded(q, t_max, s)) return true;
+		return false;
+	}
+
+	// occluded(q,t,s)
+	// Returns true if ray hits any shape of scene no further than t_max along it
+	template<typename T1, typename T2>
+	inline bool occluded(const ray<T1>& q, const double t_max, const scene<T2>& s)
+	{
+		bool bHit = false;
+		double t = t_max;
+		internal::scene_walk(s, q, t, [&](const uint32_t i, double&)
+			{
+				const auto& item = s.items[i];
+				switch (item.kind)
+				{
+				case scene_kind::line: bHit = occluded(q, t_max, s.lines[item.index]); break;
+				case scene_kind::rect: bHit = occluded(q, t_max, s.rects[item.index]); break;
+				case scene_kind::circle: bHit = occluded(q, t_max, s.circles[item.index]); break;
+				case scene_kind::triangle: bHit = occluded(q, t_max, s.triangles[item.index]); break;
+				case scene_kind::polygon: bHit = occluded(q, t_max, s.polygons[item.index]); break;
+				}
+				return bHit;
+			});
+		return bHit;
+	}
+
+	// occluded(l,vs)
+	// Returns true if any of the shapes blocks the line segment between its ends
+	template<typename T1, typename S>
+	inline bool occluded(const line<T1>& l, const std::vector<S>& shapes)
+	{
+		return occluded(ray<T1>(l.start, l.vector()), 1.0, shapes);
+	}
+
+	// occluded(l,s)
+	// Returns true if any shape of scene blocks the line segment between its ends
+	template<typename T1, typename T2>
+	inline bool occluded(const line<T1>& l, const scene<T2>& s)
+	{
+		return occluded(ray<T1>(l.start, l.vector()), 1.0, s);
+	}
+
+	// SECTORS ==============================================================================================================
+
+	// A sector is the part of a circle within an angle either side of a direction, like a
+	// view cone. Overlap tests are exact for any angle up to pi, which is the whole circle.
+	// The batch overlaps() over a vector of shapes first rejects shapes whose bounds are out
+	// of range or outside the cone's angle, only running the exact test on those left.
+
+	namespace internal
+	{
+		// Sector with the values every test needs worked out once
+		struct sector_frame
+		{
+			olc::v_2d<double> pos;
+			olc::v_2d<double> dir;
+			double radius = 0.0;
+			double cos_angle = 0.0;
+			std::array<olc::v_2d<double>, 2> edge;
+
+			template<typename T>
+			inline sector_frame(const sector<T>& s)
+				: pos(s.pos), dir(olc::v_2d<double>(s.direction).norm()), radius(double(s.radius)),
+				cos_angle(std::cos(std::min(double(s.angle), pi)))
+			{
+				edge = { olc::v_2d<double>(s.side(0).end), olc::v_2d<double>(s.side(1).end) };
+			}
+
+			// Is offset v from apex within the angle, compared without square roots
+			inline bool within_angle(const olc::v_2d<double>& v) const
+			{
+				const double d = dir.dot(v);
+				const double c2 = cos_angle * cos_angle * v.mag2();
+				return cos_angle >= 0.0 ? (d >= 0.0 && d * d >= c2) : (d >= 0.0 || d * d <= c2);
+			}
+
+			inline bool contains(const olc::v_2d<double>& p) const
+			{
+				const auto v = p - pos;
+				return v.mag2() <= radius * radius && within_angle(v);
+			}
+
+			// Does segment a-b meet the boundary of the sector
+			inline bool crosses(const olc::v_2d<double>& a, const olc::v_2d<double>& b) const
+			{
+				for (const auto& e : edge)
+				{
+					const auto d1 = b - a, d2 = e - pos, w = pos - a;
+					const double den = d1.cross(d2);
+					if (den == 0.0) continue;
+					const double t = w.cross(d2) / den, u = w.cross(d1) / den;
+					if (t >= 0.0 && t <= 1.0 && u >= 0.0 && u <= 1.0) return true;
+				}
+
+				// Arc, where the segment meets the circle within the angle
+				const auto d = b - a, f = a - pos;
+				const double A = d.mag2(), B = f.dot(d), C = f.mag2() - radius * radius;
+				const double D = B * B - A * C;
+				if (A == 0.0 || D < 0.0) return false;
+				const double s = std::sqrt(D);
+				for (const double t : { (-B - s) / A, (-B + s) / A })
+					if (t >= 0.0 && t <= 1.0 && within_angle(f + d * t)) return true;
+				return false;
+			}
+
+			// Squared distance from point to sector, zero inside
+			inline double distance2(const olc::v_2d<double>& p) const
+			{
+				const auto v = p - pos;
+				if (within_angle(v))
+				{
+					const double d = std::sqrt(v.mag2()) - radius;
+					return d > 0.0 ? d * d : 0.0;
+				}
+				return std::min(segment_distance2(pos, edge[0], p), segment_distance2(pos, edge[1], p));
+			}
+
+			// Quick check whether a circle certainly misses the sector
+			inline bool rejects(const olc::v_2d<double>& c, const double r) const
+			{
+				const auto v = c - pos;
+				if (v.mag2() > (radius + r) * (radius + r)) return true;
+
+				// Wholly beyond either straight side, only meaningful for a convex cone
+				if (cos_angle < 0.0) return false;
+				const auto n0 = (edge[0] - pos).perp(), n1 = -(edge[1] - pos).perp();
+				const double l0 = n0.mag(), l1 = n1.mag();
+				return (l0 > 0.0 && n0.dot(v) < -r * l0) || (l1 > 0.0 && n1.dot(v) < -r * l1);
+			}
+		};
+
+		template<typename T, size_t N>
+		inline bool sector_overlaps_outline(const sector_frame& f, const std::array<olc::v_2d<T>, N>& v)
+		{
+			for (size_t i = 0; i < N; i++)
+			{
+				if (f.contains(v[i])) return true;
+				if (f.crosses(v[i], v[(i + 1) % N])) return true;
+			}
+			return false;
+		}
+	}
+
+	// contains(s,p)
+	// Checks if point is inside sector
+	template<typename T1, typename T2>
+	inline bool contains(const sector<T1>& s, const olc::v_2d<T2>& p)
+	{
+		return internal::sector_frame(s).contains(p);
+	}
+
+	// overlaps(s,p)
+	// Checks if point overlaps sector
+	template<typename T1, typename T2>
+	inline bool overlaps(const sector<T1>& s, const olc::v_2d<T2>& p)
+	{
+		return contains(s, p);
+	}
+
+	// overlaps(s,l)
+	// Checks if line segment overlaps sector
+	template<typename T1, typename T2>
+	inline bool overlaps(const sector<T1>& s, const line<T2>& l)
+	{
+		const internal::sector_frame f(s);
+		return f.contains(l.start) || f.contains(l.end) || f.crosses(l.start, l.end);
+	}
+
+	// overlaps(s,r)
+	// Checks if rectangle overlaps sector
+	template<typename T1, typename T2>
+	inline bool overlaps(const sector<T1>& s, const rect<T2>& r)
+	{
+		const internal::sector_frame f(s);
+		return contains(r, s.pos) || internal::sector_overlaps_outline(f, internal::rect_corners(r));
+	}
+
+	// overlaps(s,c)
+	// Checks if circle overlaps sector
+	template<typename T1, typename T2>
+	inline bool overlaps(const sector<T1>& s, const circle<T2>& c)
+	{
+		const double r = double(c.radius);
+		return internal::sector_frame(s).distance2(c.pos) <= r * r;
+	}
+
+	// overlaps(s,t)
+	// Checks if triangle overlaps sector
+	template<typename T1, typename T2>
+	inline bool overlaps(const sector<T1>& s, const triangle<T2>& t)
+	{
+		const internal::sector_frame f(s);
+		return contains(t, s.pos) || internal::sector_overlaps_outline(f, t.pos);
+	}
+
+	// overlaps(p,s)
+	// Checks if sector overlaps point
+	template<typename T1, typename T2>
+	inline bool overlaps(const olc::v_2d<T1>& p, const sector<T2>& s)
+	{
+		return overlaps(s, p);
+	}
+
+	// overlaps(l,s)
+	// Checks if sector overlaps line segment
+	template<typename T1, typename T2>
+	inline bool overlaps(const line<T1>& l, const sector<T2>& s)
+	{
+		return overlaps(s, l);
+	}
+
+	// overlaps(r,s)
+	// Checks if sector overlaps rectangle
+	template<typename T1, typename T2>
+	inline bool overlaps(const rect<T1>& r, const sector<T2>& s)
+	{
+		return overlaps(s, r);
+	}
+
+	// overlaps(c,s)
+	// Checks if sector overlaps circle
+	template<typename T1, typename T2>
+	inline bool overlaps(const circle<T1>& c, const sector<T2>& s)
+	{
+		return overlaps(s, c);
+	}
+
+	// overlaps(t,s)
+	// Checks if sector overlaps triangle
+	template<typename T1, typename T2>
+	inline bool overlaps(const triangle<T1>& t, const sector<T2>& s)
+	{
+		return overlaps(s, t);
+	}
+
+	// overlaps(s,vs,out)
+	// Writes the indices of the shapes that overlap sector to out
+	template<typename T1, typename S>
+	inline void overlaps(const sector<T1>& s, const std::vector<S>& shapes, std::vector<size_t>& out)
+	{
+		out.clear();
+		const internal::sector_frame f(s);
+		for (size_t i = 0; i < shapes.size(); i++)
+		{
+			// Circle around the shape's bounding box, for the cheap range and angle rejection
+			const auto r = envelope_r(shapes[i]);
+			const olc::v_2d<double> vHalf = olc::v_2d<double>(r.size) * 0.5;
+			if (f.rejects(olc::v_2d<double>(r.pos) + vHalf, vHalf.mag())) continue;
+			if (overlaps(s, shapes[i])) out.push_back(i);
+		}
+	}
+
+	// overlaps(s,vs)
+	// Returns the indices of the shapes that overlap sector
+	template<typename T1, typename S>
+	inline std::vector<size_t> overlaps(const sector<T1>& s, const std::vector<S>& shapes)
+	{
+		std::vector<size_t> out;
+		overlaps(s, shapes, out);
+		return out;
+	}
+
+	// LIGHTING =============================================================================================================
+
+	// lighting keeps the region each of many lights can see, among occluding lines, rects,
+	// triangles and polygons. A light is only recomputed by update() when it has moved, or an
+	// occluder near it has moved, so lights around static geometry cost nothing from frame to
+	// frame. Each light keeps a visibility_cache of the occluders within a reach somewhat
+	// larger than its range. While the light moves about inside that reach the cache is
+	// kept, and only the angular order of its segments is repaired; it is only rebuilt when
+	// an occluder within reach changes, or the light leaves it. Lights that do need
+	// recomputing are independent, so are shared between threads.
+
+	namespace internal
+	{
+		// Fewest lights needing recomputing to be worth starting each thread for
+		inline constexpr size_t lighting_lights_per_thread = 8;
+		// Reach of a light's cache, as a multiple of its range
+		inline constexpr double lighting_reach = 1.5;
+	}
+
+	template<typename T>
+	struct lighting
+	{
+		// Adds a light, seeing as far as the edge of circle, returning its index
+		inline size_t add_light(const circle<T>& range)
+		{
+			lights.emplace_back(range);
+			return lights.size() - 1;
+		}
+
+		// Moves or resizes a light
+		inline void move_light(const size_t i, const circle<T>& range)
+		{
+			auto& l = lights[i];
+			l.range = range;
+			l.dirty = true;
+			const double d = (olc::v_2d<double>(range.pos) - olc::v_2d<double>(l.reach.pos)).mag();
+			if (d + double(range.radius) > double(l.reach.radius)) l.stale = true;
+		}
+
+		inline size_t light_count() const
+		{
+			return lights.size();
+		}
+
+		inline const circle<T>& light(const size_t i) const
+		{
+			return lights[i].range;
+		}
+
+		// Region lit by a light as of the last update(), turning positively. It is exact within
+		// the light's range, but may be cut short or run on outside it
+		inline const polygon<T>& lit(const size_t i) const
+		{
+			return lights[i].area;
+		}
+
+		// Adds an occluder, returning its index among occluders of the same kind
+		inline size_t add_occluder(const line<T>& l) { return add(occluders.lines, l); }
+		inline size_t add_occluder(const rect<T>& r) { return add(occluders.rects, r); }
+		inline size_t add_occluder(const triangle<T>& t) { return add(occluders.triangles, t); }
+		inline size_t add_occluder(const polygon<T>& p) { return add(occluders.polygons, p); }
+
+		// Moves or reshapes an occluder, by its index among occluders of the same kind
+		inline void move_occluder(const size_t i, const line<T>& l) { move(occluders.lines[i], l); }
+		inline void move_occluder(const size_t i, const rect<T>& r) { move(occluders.rects[i], r); }
+		inline void move_occluder(const size_t i, const triangle<T>& t) { move(occluders.triangles[i], t); }
+		inline void move_occluder(const size_t i, const polygon<T>& p) { move(occluders.polygons[i], p); }
+
+		// Occluders, by kind, with their hierarchy built
+		inline const scene<T>& occluder_scene()
+		{
+			if (!built)
+			{
+				occluders.build();
+				built = true;
+			}
+			return occluders;
+		}
+
+		// Recomputes lights that have changed since the last update, returning how many
+		inline size_t update()
+		{
+			std::vector<size_t> vDirty;
+			for (size_t i = 0; i < lights.size(); i++)
+				if (lights[i].dirty) vDirty.push_back(i);
+			if (vDirty.empty()) return 0;
+			occluder_scene();
+
+			// Threads are only started when there is enough work to outweigh starting them
+			const size_t nThreads = std::min<size_t>(std::thread::hardware_concurrency(), vDirty.size() / internal::lighting_lights_per_thread);
+			if (nThreads > 1)
+			{
+				std::vector<std::thread> vWorkers;
+				for (size_t t = 0; t < nThreads; t++)
+				{
+					vWorkers.emplace_back([&, t]()
+						{
+							std::vector<line<T>> vSegments;
+							for (size_t i = t; i < vDirty.size(); i += nThreads)
+								relight(lights[vDirty[i]], vSegments);
+						});
+				}
+				for (auto& w : vWorkers) w.join();
+			}
+			else
+			{
+				std::vector<line<T>> vSegments;
+				for (const size_t i : vDirty)
+					relight(lights[i], vSegments);
+			}
+			return vDirty.size();
+		}
+
+	private:
+		struct light_state
+		{
+			circle<T> range;
+			polygon<T> area;
+			visibility_cache cache;
+			// Circle the cache covers occluders within, which range lies inside
+			circle<T> reach;
+			// Area needs recomputing, and cache needs rebuilding first
+			bool dirty = true;
+			bool stale = true;
+
+			inline light_state(const circle<T>& r)
+				: range(r)
+			{ }
+		};
+
+		std::vector<light_state> lights;
+		scene<T> occluders;
+		// Occluders' hierarchy matches them
+		bool built = false;
+
+		template<typename S>
+		inline size_t add(std::vector<S>& shapes, const S& shape)
+		{
+			shapes.push_back(shape);
+			built = false;
+			touch(shape);
+			return shapes.size() - 1;
+		}
+
+		template<typename S>
+		inline void move(S& shape, const S& to)
+		{
+			touch(shape);
+			touch(to);
+			shape = to;
+			built = false;
+		}
+
+		// Marks lights whose cache covers the shape as needing rebuilding
+		template<typename S>
+		inline void touch(const S& shape)
+		{
+			for (auto& l : lights)
+				if (!l.stale && overlaps(l.reach, shape)) l.stale = l.dirty = true;
+		}
+
+		// Recomputes a light, first rebuilding its cache from the sides of the occluders
+		// within reach if it is stale
+		inline void relight(light_state& l, std::vector<line<T>>& vSegments) const
+		{
+			l.dirty = false;
+			l.area.pos.clear();
+			if (l.range.radius <= T(0)) return;
+			if (!l.stale)
+			{
+				visibility(l.range.pos, l.cache, l.area);
+				return;
+			}
+			l.stale = false;
+			l.reach = { l.range.pos, T(double(l.range.radius) * internal::lighting_reach) };
+
+			// Occluders whose boxes come within reach, found through the hierarchy
+			vSegments.clear();
+			auto gather = [&](const auto& s)
+			{
+				if (overlaps(l.reach, s))
+					for (size_t i = 0; i < s.side_count(); i++) vSegments.push_back(s.side(i));
+			};
+			double t_max = 0.0;
+			internal::scene_walk(occluders, ray<T>(l.reach.pos, { T(0), T(0) }), t_max, [&](const uint32_t i, double&)
+				{
+					const auto& item = occluders.items[i];
+					switch (item.kind)
+					{
+					case scene_kind::line:
+						if (overlaps(l.reach, occluders.lines[item.index])) vSegments.push_back(occluders.lines[item.index]);
+						break;
+					case scene_kind::rect: gather(occluders.rects[item.index]); break;
+					case scene_kind::triangle: gather(occluders.triangles[item.index]); break;
+					case scene_kind::polygon: gather(occluders.polygons[item.index]); break;
+					case scene_kind::circle: break;
+					}
+					return false;
+				}, double(l.reach.radius));
+
+			l.cache.build(vSegments, envelope_r(l.reach));
+			visibility(l.range.pos, l.cache, l.area);
+		}
+	};
+
+	// TIME OF IMPACT =======================================================================================================
+
+	// toi(a, va, b, vb) finds when two shapes, moving at constant velocities over one step,
+	// first touch, as a fraction of the step from 0 to 1. Unlike testing where they end up, a
+	// fast shape can't pass through a thin one unnoticed. Rect against rect, and circles
+	// against rects and circles, are solved directly. Other convex pairs use conservative
+	// advancement: GJK gives the gap and the speed they close along it, and neither moves
+	// further than could close that gap, so contact is never overshot.
+	//
+	// The normal is that of contact(), pointing from a towards b. Shapes already overlapping
+	// at the start hit at time 0, with the normal along the direction they close in. If
+	// conservative advancement runs out of iterations before the gap closes, the result is
+	// approximate: the time reached so far, which is never later than the real contact, and
+	// the direction between the shapes at that time.
+
+	struct toi_result
+	{
+		// Fraction of the step at which they touch
+		double t = 0.0;
+		// Unit normal at contact, pointing from a towards b
+		olc::v_2d<double> normal;
+	};
+
+	namespace internal
+	{
+		// Gap conservative advancement stops short of, counting shapes as touching
+		inline constexpr double toi_tolerance = 1e-6;
+
+		// Result for shapes found overlapping at t, where v is the velocity of b relative to a
+		inline toi_result toi_overlapping(const olc::v_2d<double>& v, const double t = 0.0)
+		{
+			const double m = v.mag();
+			return { t, m > 0.0 ? -v / m : olc::v_2d<double>() };
+		}
+
+		// Circle at p of radius r moving by v against rectangle [lo, hi], by its four sides
+		// pushed out by r, and four corners grown to circles of r
+		inline std::optional<toi_result> toi_rect_circle(const olc::v_2d<double>& lo, const olc::v_2d<double>& hi,
+			const olc::v_2d<double>& p, const double r, const olc::v_2d<double>& v)
+		{
+			std::optional<toi_result> hit;
+			auto consider = [&](const double t, const olc::v_2d<double>& n)
+			{
+				if (t >= 0.0 && t <= 1.0 && (!hit.has_value() || t < hit->t)) hit = toi_result{ t, n };
+			};
+
+			for (size_t a = 0; a < 2; a++)
+			{
+				const double pa = a == 0 ? p.x : p.y, va = a == 0 ? v.x : v.y;
+				const double pb = a == 0 ? p.y : p.x, vb = a == 0 ? v.y : v.x;
+				const double lb = a == 0 ? lo.y : lo.x, hb = a == 0 ? hi.y : hi.x;
+				if (va == 0.0) continue;
+
+				// The side being approached, pushed out towards the circle
+				const double face = va > 0.0 ? (a == 0 ? lo.x : lo.y) - r : (a == 0 ? hi.x : hi.y) + r;
+				const double t = (face - pa) / va;
+				const double s = pb + vb * t;
+				if (s >= lb && s <= hb)
+					consider(t, a == 0 ? olc::v_2d<double>(va > 0.0 ? -1.0 : 1.0, 0.0) : olc::v_2d<double>(0.0, va > 0.0 ? -1.0 : 1.0));
+			}
+
+			const double A = v.mag2();
+			if (A > 0.0)
+			{
+				for (const auto& k : { lo, hi, olc::v_2d<double>(lo.x, hi.y), olc::v_2d<double>(hi.x, lo.y) })
+				{
+					const auto f = p - k;
+					const double B = f.dot(v), C = f.mag2() - r * r;
+					const double D = B * B - A * C;
+					if (B >= 0.0 || D < 0.0) continue;
+					const double t = (-B - std::sqrt(D)) / A;
+					consider(t, (f + v * t) / r);
+				}
+			}
+			return hit;
+		}
+	}
+
+	// toi(a,va,b,vb)
+	// Returns when in the step two moving convex shapes first touch, and the normal there
+	template<typename S1, typename T1, typename S2, typename T2>
+	inline std::optional<toi_result> toi(const S1& a, const olc::v_2d<T1>& va, const S2& b, const olc::v_2d<T2>& vb)
+	{
+		// Move b relative to a, and advance it while it closes on a
+		const olc::v_2d<double> v = olc::v_2d<double>(vb) - olc::v_2d<double>(va);
+		gjk_simplex cache;
+		double t = 0.0;
+		olc::v_2d<double> vNormal;
+		for (size_t nIteration = 0; nIteration < 64; nIteration++)
+		{
+			const auto g = internal::gjk_offset(a, b, v * t, cache);
+			if (g.overlap) return internal::toi_overlapping(v, t);
+
+			// Aim to stop a tolerance short, where the direction between them is still clear
+			const auto n = (g.on_b - g.on_a) / (g.on_b - g.on_a).mag();
+			if (g.distance <= 2.0 * internal::toi_tolerance) return toi_result{ t, n };
+			vNormal = n;
+
+			const double dClosing = -v.dot(n);
+			if (dClosing <= 0.0) return std::nullopt;
+			t += (g.distance - internal::toi_tolerance) / dClosing;
+			if (t > 1.0) return std::nullopt;
+		}
+
+		// Still closing but not yet within tolerance, as when grazing a corner - treat the
+		// last safe time as the hit, it is never past the true one
+		return toi_result{ t, vNormal };
+	}
+
+	// toi(r,va,r,vb)
+	// Returns when in the step two moving rectangles first touch, and the normal there
+	template<typename T1, typename T2, typename T3, typename T4>
+	inline std::optional<toi_result> toi(const rect<T1>& a, const olc::v_2d<T2>& va, const rect<T3>& b, const olc::v_2d<T4>& vb)
+	{
+		// a's corner moving against b grown by a's size
+		const olc::v_2d<double> v = olc::v_2d<double>(va) - olc::v_2d<double>(vb);
+		const olc::v_2d<double> p = a.pos;
+		const olc::v_2d<double> lo = olc::v_2d<double>(b.pos) - olc::v_2d<double>(a.size);
+		const olc::v_2d<double> hi = olc::v_2d<double>(b.pos) + olc::v_2d<double>(b.size);
+
+		double tEnter = -std::numeric_limits<double>::infinity(), tExit = std::numeric_limits<double>::infinity();
+		olc::v_2d<double> n;
+		for (size_t i = 0; i < 2; i++)
+		{
+			const double s = i == 0 ? p.x : p.y, vi = i == 0 ? v.x : v.y;
+			const double l = i == 0 ? lo.x : lo.y, h = i == 0 ? hi.x : hi.y;
+			if (vi == 0.0)
+			{
+				if (s < l || s > h) return std::nullopt;
+				continue;
+			}
+			double t1 = (l - s) / vi, t2 = (h - s) / vi;
+			if (t1 > t2) std::swap(t1, t2);
+			if (t1 > tEnter)
+			{
+				tEnter = t1;
+				n = i == 0 ? olc::v_2d<double>(vi > 0.0 ? 1.0 : -1.0, 0.0) : olc::v_2d<double>(0.0, vi > 0.0 ? 1.0 : -1.0);
+			}
+			tExit = std::min(tExit, t2);
+		}
+
+		if (tEnter > tExit || tExit < 0.0 || tEnter > 1.0) return std::nullopt;
+		if (tEnter <= 0.0) return internal::toi_overlapping(-v);
+		return toi_result{ tEnter, n };
+	}
+
+	// toi(r,va,c,vb)
+	// Returns when in the step a moving rectangle and circle first touch, and the normal there
+	template<typename T1, typename T2, typename T3, typename T4>
+	inline std::optional<toi_result> toi(const rect<T1>& a, const olc::v_2d<T2>& va, const circle<T3>& b, const olc::v_2d<T4>& vb)
+	{
+		const olc::v_2d<double> v = olc::v_2d<double>(vb) - olc::v_2d<double>(va);
+		if (overlaps(a, b)) return internal::toi_overlapping(v);
+		const olc::v_2d<double> lo = a.pos, hi = a.pos + a.size;
+		return internal::toi_rect_circle(lo.min(hi), lo.max(hi), b.pos, double(b.radius), v);
+	}
+
+	// toi(c,va,r,vb)
+	// Returns when in the step a moving circle and rectangle first touch, and the normal there
+	template<typename T1, typename T2, typename T3, typename T4>
+	inline std::optional<toi_result> toi(const circle<T1>& a, const olc::v_2d<T2>& va, const rect<T3>& b, const olc::v_2d<T4>& vb)
+	{
+		auto hit = toi(b, vb, a, va);
+		if (hit.has_value()) hit->normal = -hit->normal;
+		return hit;
+	}
+
+	// toi(c,va,c,vb)
+	// Returns when in the step two moving circles first touch, and the normal there
+	template<typename T1, typename T2, typename T3, typename T4>
+	inline std::optional<toi_result> toi(const circle<T1>& a, const olc::v_2d<T2>& va, const circle<T3>& b, const olc::v_2d<T4>& vb)
+	{
+		const olc::v_2d<double> p = olc::v_2d<double>(b.pos) - olc::v_2d<double>(a.pos);
+		const olc::v_2d<double> v = olc::v_2d<double>(vb) - olc::v_2d<double>(va);
+		const double r = double(a.radius) + double(b.radius);
+		const double C = p.mag2() - r * r;
+		if (C <= 0.0) return internal::toi_overlapping(v);
+
+		const double A = v.mag2(), B = p.dot(v);
+		const double D = B * B - A * C;
+		if (B >= 0.0 || D < 0.0) return std::nullopt;
+		const double t = (-B - std::sqrt(D)) / A;
+		if (t > 1.0) return std::nullopt;
+		return toi_result{ t, (p + v * t) / r };
+	}
+
+	// SWEEPS ===============================================================================================================
+
+	// sweep() moves a batch of circles, each by its own velocity over one step, through a
+	// scene, finding the first shape each touches. The path of a circle's middle is walked
+	// through the scene's hierarchy with boxes grown by the radius, so only shapes near the
+	// path are tested, and once a hit is found only nearer ones. Each test is the circle's
+	// middle against the shape grown by the radius - capsules around sides, circles around
+	// corners - solved directly without allocating. Large batches are split across threads.
+
+	struct sweep_hit
+	{
+		// Fraction of the step at which the circle touches
+		double t = 0.0;
+		// Unit normal of the surface touched, pointing back towards the circle
+		olc::v_2d<double> normal;
+		// Shape touched
+		scene_item item;
+	};
+
+	namespace internal
+	{
+		// Circles each thread must have before sweep() splits its input across threads
+		inline constexpr size_t sweep_circles_per_thread = 512;
+
+		// Circle of radius r at p, moving by v, against point k. On touching no later than
+		// t_max, lowers t_max to when and returns true.
+		inline bool sweep_point(const olc::v_2d<double>& p, const olc::v_2d<double>& v, const double r,
+			const olc::v_2d<double>& k, double& t_max, olc::v_2d<double>& normal)
+		{
+			const auto f = p - k;
+			const double A = v.mag2(), B = f.dot(v), C = f.mag2() - r * r;
+			if (C <= 0.0)
+			{
+				t_max = 0.0;
+				normal = f.mag2() > 0.0 ? f.norm() : (A > 0.0 ? -v.norm() : olc::v_2d<double>());
+				return true;
+			}
+
+			const double D = B * B - A * C;
+			if (A == 0.0 || B >= 0.0 || D < 0.0) return false;
+			const double t = (-B - std::sqrt(D)) / A;
+			if (t > t_max) return false;
+			t_max = t;
+			normal = (f + v * t) / r;
+			return true;
+		}
+
+		// As sweep_point(), against segment a-b, via its capsule of radius r
+		inline bool sweep_segment(const olc::v_2d<double>& p, const olc::v_2d<double>& v, const double r,
+			const olc::v_2d<double>& a, const olc::v_2d<double>& b, double& t_max, olc::v_2d<double>& normal)
+		{
+			bool bHit = false;
+			const auto e = b - a;
+			const double l2 = e.mag2();
+			if (l2 > 0.0)
+			{
+				// Side of the capsule facing the circle
+				auto n = e.perp() / std::sqrt(l2);
+				if (n.dot(p - a) < 0.0) n = -n;
+				const double h = n.dot(p - a) - r;
+				if (h <= 0.0)
+				{
+					const double s = e.dot(p - a) / l2;
+					if (s >= 0.0 && s <= 1.0)
+					{
+						t_max = 0.0;
+						normal = n;
+						return true;
+					}
+				}
+				else if (n.dot(v) < 0.0)
+				{
+					const double t = h / -n.dot(v);
+					const double s = e.dot(p + v * t - a) / l2;
+					if (t <= t_max && s >= 0.0 && s <= 1.0)
+					{
+						t_max = t;
+						normal = n;
+						bHit = true;
+					}
+				}
+			}
+
+			// Evaluate both ends, either may be nearer
+			const bool bStart = sweep_point(p, v, r, a, t_max, normal);
+			const bool bEnd = sweep_point(p, v, r, b, t_max, normal);
+			return bHit || bStart || bEnd;
+		}
+
+		// As sweep_point(), against a closed outline, touching at once if p starts inside
+		template<typename T>
+		inline bool sweep_outline(const olc::v_2d<double>& p, const olc::v_2d<double>& v, const double r,
+			const olc::v_2d<T>* pts, const size_t n, double& t_max, olc::v_2d<double>& normal)
+		{
+			bool bInside = false;
+			for (size_t i = 0, j = n - 1; i < n; j = i++)
+			{
+				const olc::v_2d<double> a = pts[i], b = pts[j];
+				if ((a.y > p.y) != (b.y > p.y) && p.x < a.x + (b.x - a.x) * (p.y - a.y) / (b.y - a.y)) bInside = !bInside;
+			}
+			if (bInside)
+			{
+				t_max = 0.0;
+				normal = v.mag2() > 0.0 ? -v.norm() : olc::v_2d<double>();
+				return true;
+			}
+
+			bool bHit = false;
+			for (size_t i = 0; i < n; i++)
+				if (sweep_segment(p, v, r, pts[i], pts[(i + 1) % n], t_max, normal)) bHit = true;
+			return bHit;
+		}
+
+		template<typename T1>
+		inline bool sweep_item(const scene<T1>& s, const scene_item& item, const olc::v_2d<double>& p, const olc::v_2d<double>& v,
+			const double r, double& t_max, olc::v_2d<double>& normal)
+		{
+			switch (item.kind)
+			{
+			case scene_kind::line:
+			{
+				const auto& l = s.lines[item.index];
+				return sweep_segment(p, v, r, l.start, l.end, t_max, normal);
+			}
+			case scene_kind::rect:
+			{
+				const auto& b = s.rects[item.index];
+				const olc::v_2d<double> lo = olc::v_2d<double>(b.pos).min(olc::v_2d<double>(b.pos + b.size));
+				const olc::v_2d<double> hi = olc::v_2d<double>(b.pos).max(olc::v_2d<double>(b.pos + b.size));
+				const auto c = p.max(lo).min(hi);
+				if ((p - c).mag2() <= r * r)
+				{
+					t_max = 0.0;
+					normal = p != c ? (p - c).norm() : (v.mag2() > 0.0 ? -v.norm() : olc::v_2d<double>());
+					return true;
+				}
+				const auto hit = toi_rect_circle(lo, hi, p, r, v);
+				if (!hit.has_value() || hit->t > t_max) return false;
+				t_max = hit->t;
+				normal = hit->normal;
+				return true;
+			}
+			case scene_kind::circle:
+			{
+				const auto& c = s.circles[item.index];
+				return sweep_point(p, v, r + double(c.radius), c.pos, t_max, normal);
+			}
+			case scene_kind::triangle:
+			{
+				const auto& t = s.triangles[item.index];
+				return sweep_outline(p, v, r, t.pos.data(), 3, t_max, normal);
+			}
+			case scene_kind::polygon:
+			{
+				const auto& g = s.polygons[item.index];
+				return !g.pos.empty() && sweep_outline(p, v, r, g.pos.data(), g.pos.size(), t_max, normal);
+			}
+			}
+			return false;
+		}
+
+		template<typename T1, typename T2, typename T3>
+		inline std::optional<sweep_hit> sweep_circle(const scene<T1>& s, const circle<T2>& c, const olc::v_2d<T3>& velocity)
+		{
+			const olc::v_2d<double> p = c.pos, v = velocity;
+			const double r = double(c.radius);
+			double t_max = 1.0;
+			std::optional<sweep_hit> hit;
+			scene_walk(s, ray<double>(p, v), t_max, [&](const uint32_t i, double& t)
+				{
+					olc::v_2d<double> n;
+					if (sweep_item(s, s.items[i], p, v, r, t, n)) hit = sweep_hit{ t, n, s.items[i] };
+					return t == 0.0;
+				}, r);
+			return hit;
+		}
+	}
+
+	// sweep(s,vc,vv,hits)
+	// For each circle moving by its velocity over a step, finds the first shape in scene it
+	// touches, writing to hits (nullopt for those that touch nothing)
+	template<typename T1, typename T2, typename T3>
+	inline void sweep(const scene<T1>& s, const std::vector<circle<T2>>& circles, const std::vector<olc::v_2d<T3>>& velocities,
+		std::vector<std::optional<sweep_hit>>& hits)
+	{
+		hits.resize(circles.size());
+
+		// Threads are only started when there is enough work to outweigh starting them
+		const size_t nThreads = std::min<size_t>(std::thread::hardware_concurrency(), circles.size() / internal::sweep_circles_per_thread);
+		if (nThreads > 1)
+		{
+			std::vector<std::thread> vWorkers;
+			for (size_t t = 0; t < nThreads; t++)
+			{
+				vWorkers.emplace_back([&, t]()
+					{
+						for (size_t i = t; i < circles.size(); i += nThreads)
+							hits[i] = internal::sweep_circle(s, circles[i], velocities[i]);
+					});
+			}
+			for (auto& w : vWorkers) w.join();
+		}
+		else
+		{
+			for (size_t i = 0; i < circles.size(); i++)
+				hits[i] = internal::sweep_circle(s, circles[i], velocities[i]);
+		}
+	}
+
+	// sweep(s,vc,vv)
+	// Returns the first shape in scene each circle touches moving by its velocity over a step
+	template<typename T1, typename T2, typename T3>
+	inline std::vector<std::optional<sweep_hit>> sweep(const scene<T1>& s, const std::vector<circle<T2>>& circles,
+		const std::vector<olc::v_2d<T3>>& velocities)
+	{
+		std::vector<std::optional<sweep_hit>> hits;
+		sweep(s, circles, velocities, hits);
+		return hits;
+	}
+
+	// NARROWPHASE CACHE ====================================================================================================
+
+	// From one frame to the next, a pair of shapes that were apart are usually still apart,
+	// and along much the same direction. A narrowphase remembers, for each pair by an id of
+	// the caller's choosing, the axis that last separated them and GJK's last simplex. The
+	// axis is tried first, costing one projection of each shape; only if it no longer
+	// separates them is GJK run, warm-started from the simplex. Pass the shapes of a pair in
+	// the same order each time. A narrowphase is not safe to share between threads.
+
+	namespace internal
+	{
+		// True if the shapes' projections onto axis don't meet, whichever side each is on
+		template<typename S1, typename S2>
+		inline bool narrowphase_separates(const S1& a, const S2& b, const olc::v_2d<double>& axis)
+		{
+			const double ra = support_radius(a), rb = support_radius(b);
+			const double a_max = support(a, axis).dot(axis) + ra, a_min = support(a, -axis).dot(axis) - ra;
+			const double b_max = support(b, axis).dot(axis) + rb, b_min = support(b, -axis).dot(axis) - rb;
+			return a_max < b_min || b_max < a_min;
+		}
+	}
+
+	struct narrowphase
+	{
+		// Queries made, and how many were decided by the remembered axis alone
+		size_t queries = 0;
+		size_t early_outs = 0;
+
+		// Makes an id for a pair from two shape ids, the same whichever order they come in
+		static inline uint64_t pair_id(const uint32_t a, const uint32_t b)
+		{
+			return (uint64_t(std::min(a, b)) << 32) | uint64_t(std::max(a, b));
+		}
+
+		// Check if convex shapes a and b overlap, trying their last separating axis first
+		template<typename S1, typename S2>
+		inline bool overlaps(const uint64_t id, const S1& a, const S2& b)
+		{
+			queries++;
+			const size_t i = find(id);
+			auto& e = table[i];
+			e.frame = frame;
+			if (e.separated && internal::narrowphase_separates(a, b, e.axis))
+			{
+				early_outs++;
+				return false;
+			}
+
+			// GJK's closest points give the direction they are furthest apart along
+			const auto g = internal::gjk_offset(a, b, { 0.0, 0.0 }, simplex[i]);
+			e.separated = !g.overlap;
+			if (e.separated) e.axis = (g.on_b - g.on_a).norm();
+			return g.overlap;
+		}
+
+		inline double early_out_rate() const
+		{
+			return queries > 0 ? double(early_outs) / double(queries) : 0.0;
+		}
+
+		// Forgets pairs not queried since the last prune(), so only live pairs are kept
+		inline void prune()
+		{
+			rehash(table.size(), true);
+			frame++;
+		}
+
+		inline void clear()
+		{
+			table.clear();
+			simplex.clear();
+			count = 0;
+			queries = 0;
+			early_outs = 0;
+		}
+
+		// Number of pairs remembered
+		inline size_t size() const
+		{
+			return count;
+		}
+
+	private:
+		struct entry
+		{
+			uint64_t id = 0;
+			olc::v_2d<double> axis;
+			uint32_t frame = 0;
+			bool separated = false;
+			bool used = false;
+		};
+
+		// Open addressed, with linear probing, kept at most half full. Simplexes are only
+		// needed when the axis fails, so are kept apart to keep the table small.
+		std::vector<entry> table;
+		std::vector<gjk_simplex> simplex;
+		size_t count = 0;
+		uint32_t frame = 0;
+
+		inline void rehash(const size_t nSize, const bool bLiveOnly)
+		{
+			std::vector<entry> vOld;
+			std::vector<gjk_simplex> vOldSimplex;
+			vOld.swap(table);
+			vOldSimplex.swap(simplex);
+			table.resize(nSize);
+			simplex.resize(nSize);
+			count = 0;
+			for (size_t i = 0; i < vOld.size(); i++)
+			{
+				if (!vOld[i].used || (bLiveOnly && vOld[i].frame != frame)) continue;
+				const size_t j = find(vOld[i].id);
+				table[j] = vOld[i];
+				simplex[j] = vOldSimplex[i];
+			}
+		}
+
+		// Finds the slot for a pair, adding it if new
+		inline size_t find(const uint64_t id)
+		{
+			if (2 * (count + 1) > table.size()) rehash(std::max<size_t>(64, table.size() * 2), false);
+
+			const size_t nMask = table.size() - 1;
+			size_t i = size_t((id * 0x9E3779B97F4A7C15ull) >> 32) & nMask;
+			while (table[i].used && table[i].id != id) i = (i + 1) & nMask;
+			if (!table[i].used)
+			{
+				table[i] = entry();
+				table[i].id = id;
+				table[i].used = true;
+				simplex[i] = gjk_simplex();
+				count++;
+			}
+			return i;
+		}
+	};
+
+	// ISLANDS ==============================================================================================================
+
+	// Islands are groups of items connected by pairs, such as shapes found overlapping, so
+	// each group can be handled on its own. An island_builder joins pairs with a union-find
+	// whose links are single atomic swaps, so many threads can feed it pairs at once without
+	// locks. A root is only ever linked beneath a smaller index, so whatever order the pairs
+	// arrive in, each island ends up named by its smallest item. build() then lays the
+	// islands out one after another, for handing out to threads downstream.
+
+	// Islands laid out together, each given by a range of items
+	struct island_set
+	{
+		// Items of every island, each island's together in ascending order
+		std::vector<uint32_t> items;
+		// Island i is items [offsets[i], offsets[i + 1])
+		std::vector<uint32_t> offsets;
+		// Island each item belongs to
+		std::vector<uint32_t> island;
+
+		// Number of islands, including lone items
+		inline size_t count() const
+		{
+			return offsets.empty() ? 0 : offsets.size() - 1;
+		}
+
+		// Number of items in an island
+		inline size_t size(const size_t i) const
+		{
+			return offsets[i + 1] - offsets[i];
+		}
+
+		// First item of an island, followed by the rest
+		inline const uint32_t* begin(const size_t i) const
+		{
+			return items.data() + offsets[i];
+		}
+
+		inline const uint32_t* end(const size_t i) const
+		{
+			return items.data() + offsets[i + 1];
+		}
+	};
+
+	struct island_builder
+	{
+		inline island_builder(const size_t n = 0)
+		{
+			reset(n);
+		}
+
+		// Starts again with n items, each alone
+		inline void reset(const size_t n)
+		{
+			parent = std::vector<std::atomic<uint32_t>>(n);
+			for (uint32_t i = 0; i < uint32_t(n); i++) parent[i].store(i, std::memory_order_relaxed);
+		}
+
+		inline size_t item_count() const
+		{
+			return parent.size();
+		}
+
+		// Smallest item of the island an item is in so far, halving the path there as it goes
+		inline uint32_t find(uint32_t i)
+		{
+			while (true)
+			{
+				uint32_t p = parent[i].load(std::memory_order_relaxed);
+				if (p == i) return i;
+				const uint32_t g = parent[p].load(std::memory_order_relaxed);
+				if (p != g) parent[i].compare_exchange_weak(p, g, std::memory_order_relaxed);
+				i = g;
+			}
+		}
+
+		// Joins the islands of two items. Safe to call from many threads at once.
+		inline void unite(uint32_t a, uint32_t b)
+		{
+			while (true)
+			{
+				a = find(a);
+				b = find(b);
+				if (a == b) return;
+				if (a < b) std::swap(a, b);
+
+				// Fails if a stopped being a root meanwhile, in which case try again
+				uint32_t expected = a;
+				if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
+			}
+		}
+
+		// Writes the islands found, numbered in order of their smallest item. Call once
+		// all threads have finished uniting.
+		inline void build(island_set& out)
+		{
+			const size_t n = parent.size();
+			out.island.resize(n);
+			out.items.resize(n);
+			out.offsets.clear();
+
+			// Roots come before their items, so are numbered first
+			uint32_t nIslands = 0;
+			for (uint32_t i = 0; i < uint32_t(n); i++)
+			{
+				const uint32_t r = find(i);
+				out.island[i] = r == i ? nIslands++ : out.island[r];
+			}
+
+			out.offsets.assign(size_t(nIslands) + 1, 0);
+			for (size_t i = 0; i < n; i++) out.offsets[out.island[i] + 1]++;
+			for (size_t i = 0; i < nIslands; i++) out.offsets[i + 1] += out.offsets[i];
+
+			std::vector<uint32_t> vFill(out.offsets.begin(), out.offsets.end() - 1);
+			for (uint32_t i = 0; i < uint32_t(n); i++) out.items[vFill[out.island[i]]++] = i;
+		}
+
+	private:
+		std::vector<std::atomic<uint32_t>> parent;
+	};
+
+	namespace internal
+	{
+		// Pairs each thread must have before islands() splits its input across threads
+		inline constexpr size_t islands_pairs_per_thread = 32768;
+	}
+
+	// islands(n,vp,out)
+	// Groups n items into islands connected by pairs of item indices, writing them to out
+	template<typename T1, typename T2>
+	inline void islands(const size_t n, const std::vector<std::pair<T1, T2>>& pairs, island_set& out)
+	{
+		island_builder builder(n);
+
+		// Threads are only started when there is enough work to outweigh starting them
+		const size_t nThreads = std::min<size_t>(std::thread::hardware_concurrency(), pairs.size() / internal::islands_pairs_per_thread);
+		if (nThreads > 1)
+		{
+			std::vector<std::thread> vWorkers;
+			const size_t nChunk = (pairs.size() + nThreads - 1) / nThreads;
+			for (size_t t = 0; t < nThreads; t++)
+			{
+				vWorkers.emplace_back([&, t]()
+					{
+						const size_t nEnd = std::min(pairs.size(), (t + 1) * nChunk);
+						for (size_t i = t * nChunk; i < nEnd; i++)
+							builder.unite(uint32_t(pairs[i].first), uint32_t(pairs[i].second));
+					});
+			}
+			for (auto& w : vWorkers) w.join();
+		}
+		else
+		{
+			for (const auto& p : pairs)
+				builder.unite(uint32_t(p.first), uint32_t(p.second));
+		}
+
+		builder.build(out);
+	}
+
+	// islands(n,vp)
+	// Returns n items grouped into islands connected by pairs of item indices
+	template<typename T1, typename T2>
+	inline island_set islands(const size_t n, const std::vector<std::pair<T1, T2>>& pairs)
+	{
+		island_set out;
+		islands(n, pairs, out);
+		return out;
+	}
 }
 
 #endif // PGE_VER